@@ -36,6 +36,8 @@ namespace Raytracer::Arguments
         ARG_SPHERE,
         ARG_SPHERE_MOVING,
         ARG_BOX,
+        ARG_MESH,
+        ARG_INSTANCE,
     };
 }
 
@@ -1,9 +1,12 @@
 #include <memory>
+#include <string>
 #include "Common.hpp"
 #include "arguments/Kinds.hpp"
 #include "interfaces/IArguments.hpp"
 #include "interfaces/IMaterial.hpp"
+#include "interfaces/IHittable.hpp"
 #include "interfaces/ITexture.hpp"
+#include "utils/Affine.hpp"
 #include "utils/VecN.hpp"
 
 #ifndef __ARG_SHAPES_HPP__
@@ -137,6 +140,40 @@ namespace Raytracer::Arguments
         GET_SET(std::shared_ptr<Interfaces::IMaterial>, material);
         ARG_KIND(ArgumentKind::ARG_BOX);
     };
+
+    class Mesh : public Interfaces::IArguments {
+      private:
+        std::string _path;
+        double _scale;
+        std::shared_ptr<Interfaces::IMaterial> _material = nullptr;
+
+      public:
+        Mesh(const std::string &path, double scale,
+            std::shared_ptr<Interfaces::IMaterial> material)
+            : _path(path), _scale(scale), _material(material)
+        {
+        }
+        GET_SET(std::string, path);
+        GET_SET(double, scale);
+        GET_SET(std::shared_ptr<Interfaces::IMaterial>, material);
+        ARG_KIND(ArgumentKind::ARG_MESH);
+    };
+
+    class Instance : public Interfaces::IArguments {
+      private:
+        std::shared_ptr<Interfaces::IHittable> _object = nullptr;
+        Utils::Affine _transform;
+
+      public:
+        Instance(std::shared_ptr<Interfaces::IHittable> object,
+            const Utils::Affine &transform)
+            : _object(object), _transform(transform)
+        {
+        }
+        GET_SET(std::shared_ptr<Interfaces::IHittable>, object);
+        GET_SET(Utils::Affine, transform);
+        ARG_KIND(ArgumentKind::ARG_INSTANCE);
+    };
 } // namespace Raytracer::Arguments
 
 #endif /* __ARG_SHAPES_HPP__ */
@@ -0,0 +1,42 @@
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "config/Manager.hpp"
+#include "core/Camera.hpp"
+
+#ifndef __CFG_DAEMON_HPP__
+    #define __CFG_DAEMON_HPP__
+
+namespace Raytracer::Config
+{
+    class Daemon {
+      private:
+        struct Entry {
+            std::unique_ptr<Manager> manager;
+            Core::Camera camera;
+            std::filesystem::file_time_type time;
+        };
+
+        std::string _path;
+        Core::Camera _defaults;
+        std::unordered_map<std::string, Entry> _scenes;
+
+      public:
+        static constexpr int receiveTimeout = 5;
+
+        Daemon(const std::string &path, const Core::Camera &defaults);
+        bool run();
+
+      private:
+        static bool trusted(int client);
+        std::string receive(int client);
+        std::string handle(const std::string &request);
+        Entry *load(const std::string &path, bool &cached);
+        static bool override(Core::Camera &camera, const std::string &key,
+            std::istringstream &value);
+    };
+} // namespace Raytracer::Config
+
+#endif /* __CFG_DAEMON_HPP__ */
@@ -43,6 +43,8 @@ namespace Raytracer::Config
         SHAPE_QUAD,
         SHAPE_SPHERE,
         SHAPE_MOVING_SPHERE,
+        SHAPE_MESH,
+        SHAPE_INSTANCE,
     };
 
     template <typename I, typename E>
@@ -4,16 +4,22 @@
 #include <optional>
 #include <string>
 #include <variant>
+#include <vector>
 #include "Common.hpp"
+#include "core/Animation.hpp"
 #include "core/Camera.hpp"
 #include "core/Scene.hpp"
 #include "interfaces/IArguments.hpp"
 #include "interfaces/IHittable.hpp"
 #include "interfaces/IMaterial.hpp"
 #include "interfaces/ITexture.hpp"
+#include "utils/Affine.hpp"
+#include "utils/BVHNode.hpp"
+#include "utils/BVHSettings.hpp"
 #include "libconfig.h++"
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 #ifndef __CFG_MANAGER_HPP__
     #define __CFG_MANAGER_HPP__
@@ -25,21 +31,49 @@ namespace Raytracer::Config
 
     using KeyTypes = std::tuple<double, int, int, int, Raytracer::Utils::Color,
         int, Raytracer::Utils::Point3, Raytracer::Utils::Point3,
-        Raytracer::Utils::Point3, double>;
+        Raytracer::Utils::Point3, double, std::string, int, double, int,
+        std::string>;
+
+    constexpr std::size_t CameraKeys = std::tuple_size_v<KeyTypes>;
 
     template <int I> using KeyType = std::tuple_element_t<I, KeyTypes>;
 
-    using CameraTypes = std::variant<int, double, Raytracer::Utils::Vec3>;
+    using CameraTypes =
+        std::variant<int, double, Raytracer::Utils::Vec3, std::string>;
 
     class Manager {
       private:
+        struct Resident {
+            std::unordered_map<std::string, std::shared_ptr<void>> cache;
+            ManagerMap<Interfaces::IHittable> shapes;
+            std::unordered_set<std::string> prototypes;
+            std::shared_ptr<Utils::BVHNode> tree;
+            double treeCost = 0;
+            Raytracer::Utils::BVHSettings acceleration;
+        };
+
         Raytracer::Core::Scene _world;
         Raytracer::Core::Camera _camera;
+        Raytracer::Utils::BVHSettings _acceleration;
+        Raytracer::Core::Animation _animation;
+        std::optional<Raytracer::Core::Scene> _accelerated;
+        std::shared_ptr<Utils::BVHNode> _tree;
+        double _treeCost = 0;
+        std::optional<Resident> _resident;
+        std::unordered_map<std::string, std::string> _signatures;
+        std::unordered_map<std::string, std::shared_ptr<void>> _cache;
+        std::vector<std::string> _files;
+        int _parsed = 0;
+        int _reused = 0;
         std::vector<std::string> _ids;
         ManagerMap<Interfaces::ITexture> _textures;
         ManagerMap<Interfaces::IHittable> _effects;
         ManagerMap<Interfaces::IMaterial> _materials;
         ManagerMap<Interfaces::IHittable> _shapes;
+        std::unordered_set<std::string> _prototypes;
+        std::unordered_map<const Interfaces::IHittable *,
+            std::shared_ptr<Interfaces::IHittable>>
+            _bottomLevels;
         std::unordered_map<std::string,
             std::function<std::shared_ptr<Interfaces::IArguments>(
                 libconfig::Setting &)>>
@@ -52,16 +86,38 @@ namespace Raytracer::Config
         Manager();
         bool parse(std::string path);
         void bootstrap();
-        void render(bool fast);
+        void reuse(const Manager &resident);
+        bool render(bool fast);
+        void benchmark(bool fast);
         GET_SET(Raytracer::Core::Scene, world);
         GET_SET(Raytracer::Core::Camera, camera);
+        GET_SET(Raytracer::Utils::BVHSettings, acceleration);
+        GET_SET(Raytracer::Core::Animation, animation);
+        GET_SET(std::vector<std::string>, files);
+        GET_SET(int, parsed);
+        GET_SET(int, reused);
 
       private:
+        bool animate();
+        std::shared_ptr<Utils::BVHNode> build(Core::Scene &unbounded);
+        std::shared_ptr<Utils::BVHNode> refit(Core::Scene &unbounded);
+        Core::Scene lights() const;
+        static std::shared_ptr<Interfaces::IHittable> accelerate(
+            const std::shared_ptr<Utils::BVHNode> &tree,
+            Utils::BVHLayout layout);
+        std::shared_ptr<Interfaces::IHittable> bottomLevel(
+            const std::shared_ptr<Interfaces::IHittable> &object);
+        static Utils::Affine parseTransform(const libconfig::Setting &args);
         template <typename I, typename E>
             requires std::is_enum_v<E>
         void genericParse(
             const libconfig::Setting &arguments, ManagerMap<I> &containerMap);
         static Utils::Color parseColor(const libconfig::Setting &color);
+        std::string signature(
+            const std::string &kind, const libconfig::Setting &root) const;
+        void serialize(
+            const libconfig::Setting &setting, std::string &text) const;
+        std::uint64_t contentHash() const;
         template <typename I>
         std::shared_ptr<I> retrieve(const libconfig::Setting &arguments,
             ManagerMap<I> &containerMap, const std::string &name);
@@ -69,6 +125,8 @@ namespace Raytracer::Config
             const std::string &type, libconfig::Setting &args);
         void parseCamera(const libconfig::Setting &camera);
         void parseImports(const libconfig::Setting &imports);
+        void parseAcceleration(const libconfig::Setting &acceleration);
+        void parseAnimation(const libconfig::Setting &animation);
         template <typename T>
             requires std::is_arithmetic_v<T>
         std::optional<T> parseOptional(
@@ -77,12 +135,17 @@ namespace Raytracer::Config
             requires std::is_same_v<T, Raytracer::Utils::Vec3>
         std::optional<T> parseOptional(
             const libconfig::Setting &setting, std::string &name);
+        template <typename T>
+            requires std::is_same_v<T, std::string>
+        std::optional<T> parseOptional(
+            const libconfig::Setting &setting, std::string &name);
         template <std::size_t I>
         void extract(const libconfig::Setting &setting,
-            std::array<std::string, 10> &keys);
+            std::array<std::string, CameraKeys> &keys);
         template <std::size_t... Is>
         void parseCameraHelper(const libconfig::Setting &camera,
-            std::array<std::string, 10> &keys, std::index_sequence<Is...>);
+            std::array<std::string, CameraKeys> &keys,
+            std::index_sequence<Is...>);
     };
 } // namespace Raytracer::Config
 
@@ -0,0 +1,37 @@
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "config/Manager.hpp"
+
+#ifndef __CFG_WATCHER_HPP__
+    #define __CFG_WATCHER_HPP__
+
+namespace Raytracer::Config
+{
+    class Watcher {
+      public:
+        using Setup = std::function<void(Manager &)>;
+
+      private:
+        std::string _path;
+        Setup _setup;
+        bool _fast;
+        std::unique_ptr<Manager> _manager;
+        std::unordered_map<std::string, std::filesystem::file_time_type>
+            _times;
+
+      public:
+        static constexpr double pollInterval = 0.25;
+
+        Watcher(const std::string &path, const Setup &setup, bool fast);
+        bool run();
+
+      private:
+        bool load();
+        bool changed() const;
+    };
+} // namespace Raytracer::Config
+
+#endif /* __CFG_WATCHER_HPP__ */
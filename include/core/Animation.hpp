@@ -0,0 +1,52 @@
+#include <optional>
+#include <string>
+#include <vector>
+#include "Common.hpp"
+#include "core/Camera.hpp"
+#include "utils/VecN.hpp"
+
+#ifndef __ANIMATION_HPP__
+    #define __ANIMATION_HPP__
+
+namespace Raytracer::Core
+{
+    class Keyframe {
+      private:
+        int _frame = 0;
+        std::optional<Utils::Point3> _lookFrom;
+        std::optional<Utils::Point3> _lookAt;
+        std::optional<double> _vFov;
+        std::optional<double> _defocusAngle;
+
+      public:
+        Keyframe() = default;
+        GET_SET(int, frame)
+        GET_SET(std::optional<Utils::Point3>, lookFrom)
+        GET_SET(std::optional<Utils::Point3>, lookAt)
+        GET_SET(std::optional<double>, vFov)
+        GET_SET(std::optional<double>, defocusAngle)
+    };
+
+    class Animation {
+      private:
+        int _start = 0;
+        int _end = 0;
+        std::vector<Keyframe> _keyframes;
+
+      public:
+        Animation() = default;
+        bool empty() const;
+        void add(const Keyframe &keyframe);
+        void apply(Camera &camera, int frame) const;
+        static std::string framePath(const std::string &path, int frame);
+        GET_SET(int, start)
+        GET_SET(int, end)
+        GET_SET(std::vector<Keyframe>, keyframes)
+
+      private:
+        template <typename T, typename Getter>
+        std::optional<T> interpolate(int frame, Getter get) const;
+    };
+} // namespace Raytracer::Core
+
+#endif /* __ANIMATION_HPP__ */
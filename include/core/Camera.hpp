@@ -1,7 +1,16 @@
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 #include "Common.hpp"
 #include "core/Ray.hpp"
+#include "core/Scheduler.hpp"
+#include "core/Tile.hpp"
 #include "interfaces/IHittable.hpp"
+#include "interfaces/ISampler.hpp"
+#include "samplers/Uniform.hpp"
 #include "utils/VecN.hpp"
 
 #ifndef __CAMERA_HPP__
@@ -9,6 +18,11 @@
 
 namespace Raytracer::Core
 {
+    enum class Integrator {
+        INTEGRATOR_RECURSIVE,
+        INTEGRATOR_ITERATIVE,
+    };
+
     class Camera {
       private:
         double _aspectRatio = 1.0;
@@ -16,6 +30,37 @@ namespace Raytracer::Core
         int _samplesPerPixel = 10;
         int _maxDepth = 10;
         Utils::Color _backgroundColor = Utils::Color(0, 0, 0);
+        int _threads = 1;
+        int _tileSize = 32;
+        TileOrder _tileOrder = TileOrder::ORDER_MORTON;
+        bool _statistics = false;
+        std::uint64_t _seed = 0;
+        Integrator _integrator = Integrator::INTEGRATOR_RECURSIVE;
+        int _rouletteDepth = 3;
+        double _adaptiveThreshold = 0;
+        int _minSamples = 16;
+        std::string _sampleMap;
+        std::string _output;
+        std::string _checkpoint;
+        std::uint64_t _sceneHash = 0;
+        double _checkpointInterval = 300;
+        bool _resume = false;
+        Tile _region;
+        int _samplesFrom = 0;
+        int _samplesTo = 0;
+        std::string _partial;
+        int _processes = 0;
+        std::shared_ptr<Interfaces::ISampler> _sampler =
+            std::make_shared<Samplers::Uniform>();
+        bool _progressive = false;
+        int _passSamples = 1;
+        double _timeBudget = 0;
+        double _previewInterval = 10;
+        std::function<bool()> _interrupt;
+        std::vector<Utils::Color> _accumulator;
+        std::vector<int> _samples;
+        std::vector<double> _mean;
+        std::vector<double> _squares;
 
         double _vFov = 90;
         Utils::Point3 _lookFrom = Utils::Point3(0, 0, 0);
@@ -37,22 +82,89 @@ namespace Raytracer::Core
         Utils::Vec3 _defocusDiskV;
 
       public:
+        static constexpr std::uint32_t cameraDimensions = 6;
+        static constexpr std::uint32_t bounceDimensions = 8;
+
         Camera() = default;
         void setup();
-        void render(const Interfaces::IHittable &world);
+        bool render(const Interfaces::IHittable &world,
+            const Interfaces::IHittable &lights);
+        bool trace(const Interfaces::IHittable &world,
+            const Interfaces::IHittable &lights);
+        bool write() const;
+        Tile window() const;
+        std::vector<Tile> tiles() const;
+        int sampleCount() const;
+        void reset();
+        std::uint64_t renderTile(const Interfaces::IHittable &world,
+            const Interfaces::IHittable &lights, const Tile &tile,
+            int count);
+        std::vector<char> packTile(const Tile &tile) const;
+        std::uint64_t unpackTile(
+            const Tile &tile, const std::vector<char> &data);
+        bool done(std::size_t index) const;
+        bool converged(double mean, double deviation, int count) const;
+        std::vector<Utils::Color> image() const;
+        bool writeCheckpoint(const std::vector<Tile> &finished) const;
+        bool readCheckpoint();
+        std::string checkpointHeader() const;
+        bool writePartial() const;
+        bool readPartial(const std::string &path);
+        bool merge(const std::vector<std::string> &paths);
+        bool complete(const Tile &tile) const;
+        bool writeSampleMap(const std::vector<int> &samples) const;
+        bool writeImage(const std::vector<Utils::Color> &framebuffer) const;
         Core::Ray getRay(double u, double v) const;
         Utils::Vec3 sampleSquare() const;
         Utils::Vec3 sampleDisk(double radius) const;
         Utils::Vec3 sampleDefocusDisk() const;
         Utils::Color rayColor(const Ray ray, int depth,
             const Interfaces::IHittable &world) const;
-        void progress(
-            const std::chrono::steady_clock::time_point &start, int j) const;
+        Utils::Color pathColor(Ray ray, const Interfaces::IHittable &world,
+            const Interfaces::IHittable &lights) const;
+        Utils::Color directLight(const Ray &ray, const Payload &payload,
+            const Interfaces::IHittable &world,
+            const Interfaces::IHittable &lights) const;
+        double lightPdf(const Ray &ray, double t,
+            const Interfaces::IHittable &lights) const;
+        static double powerHeuristic(double pdf, double other);
+        void progress(const std::chrono::steady_clock::time_point &start,
+            int pass, int done, int total, std::uint64_t samples) const;
         GET_SET(double, aspectRatio)
         GET_SET(int, imageWidth)
         GET_SET(int, samplesPerPixel)
         GET_SET(int, maxDepth)
         GET_SET(Utils::Color, backgroundColor)
+        GET_SET(int, threads)
+        GET_SET(int, tileSize)
+        GET_SET(TileOrder, tileOrder)
+        GET_SET(bool, statistics)
+        GET_SET(std::uint64_t, seed)
+        GET_SET(Integrator, integrator)
+        GET_SET(int, rouletteDepth)
+        GET_SET(double, adaptiveThreshold)
+        GET_SET(int, minSamples)
+        GET_SET(std::string, sampleMap)
+        GET_SET(std::string, output)
+        GET_SET(std::string, checkpoint)
+        GET_SET(std::uint64_t, sceneHash)
+        GET_SET(double, checkpointInterval)
+        GET_SET(bool, resume)
+        GET_SET(Tile, region)
+        GET_SET(int, samplesFrom)
+        GET_SET(int, samplesTo)
+        GET_SET(std::string, partial)
+        GET_SET(int, processes)
+        GET_SET(std::shared_ptr<Interfaces::ISampler>, sampler)
+        GET_SET(std::vector<Utils::Color>, accumulator)
+        GET_SET(std::vector<int>, samples)
+        GET_SET(std::vector<double>, mean)
+        GET_SET(std::vector<double>, squares)
+        GET_SET(bool, progressive)
+        GET_SET(int, passSamples)
+        GET_SET(double, timeBudget)
+        GET_SET(double, previewInterval)
+        GET_SET(std::function<bool()>, interrupt)
         GET_SET(double, vFov)
         GET_SET(Utils::Point3, lookFrom)
         GET_SET(Utils::Point3, lookAt)
@@ -0,0 +1,48 @@
+#include <functional>
+#include <ostream>
+#include <sys/types.h>
+#include <vector>
+#include "core/Tile.hpp"
+
+#ifndef __COORDINATOR_HPP__
+    #define __COORDINATOR_HPP__
+
+namespace Raytracer::Core
+{
+    class Coordinator {
+      public:
+        using Task = std::function<std::vector<char>(const Tile &)>;
+        using Gather =
+            std::function<void(const Tile &, const std::vector<char> &)>;
+
+      private:
+        struct Worker {
+            pid_t pid = -1;
+            int socket = -1;
+            Tile tile;
+            bool busy = false;
+            int rendered = 0;
+        };
+
+        int _processes;
+        std::vector<Worker> _workers;
+        int _lost = 0;
+
+      public:
+        Coordinator(int processes);
+        bool run(const std::vector<Tile> &tiles, const Task &task,
+            const Gather &gather);
+        void report(std::ostream &out) const;
+
+      private:
+        bool spawn(const Task &task);
+        [[noreturn]] void serve(int socket, const Task &task) const;
+        bool dispatch(Worker &worker, const Tile &tile);
+        bool collect(Worker &worker, std::vector<char> &result);
+        void stop();
+        static bool send(int socket, const void *data, std::size_t size);
+        static bool receive(int socket, void *data, std::size_t size);
+    };
+} // namespace Raytracer::Core
+
+#endif /* __COORDINATOR_HPP__ */
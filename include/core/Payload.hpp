@@ -8,11 +8,13 @@
 
 namespace Raytracer::Core
 {
+    using MaterialPointer = const Interfaces::IMaterial *;
+
     class Payload {
       private:
         Utils::Point3 _point;
         Utils::Vec3 _normal;
-        std::shared_ptr<Interfaces::IMaterial> _material;
+        MaterialPointer _material = nullptr;
         double _t;
         double _u;
         double _v;
@@ -24,7 +26,7 @@ namespace Raytracer::Core
             const Core::Ray &ray, const Utils::Vec3 &outwardNormal);
         GET_SET(Utils::Point3, point)
         GET_SET(Utils::Vec3, normal)
-        GET_SET(std::shared_ptr<Interfaces::IMaterial>, material)
+        GET_SET(MaterialPointer, material)
         GET_SET(double, t)
         GET_SET(double, u)
         GET_SET(double, v)
@@ -20,6 +20,10 @@ namespace Raytracer::Core
         bool hit(const Core::Ray &ray, Utils::Interval interval,
             Core::Payload &payload) const override;
         Utils::AxisAlignedBBox boundingBox() const override;
+        bool emissive() const override;
+        double pdfValue(const Utils::Point3 &origin,
+            const Utils::Vec3 &direction) const override;
+        Utils::Vec3 random(const Utils::Point3 &origin) const override;
         GET_SET(std::vector<std::shared_ptr<Interfaces::IHittable>>, objects)
     };
 } // namespace Raytracer::Core
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "core/Tile.hpp"
+
+#ifndef __SCHEDULER_HPP__
+    #define __SCHEDULER_HPP__
+
+namespace Raytracer::Core
+{
+    enum class TileOrder {
+        ORDER_SCANLINE,
+        ORDER_MORTON,
+        ORDER_SPIRAL,
+    };
+
+    class Scheduler {
+      private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Tile> tiles;
+            std::chrono::duration<double> busy{0};
+            std::chrono::duration<double> idle{0};
+            int rendered = 0;
+            int stolen = 0;
+        };
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        TileOrder _order;
+        int _tileSize;
+        std::chrono::duration<double> _elapsed{0};
+
+      public:
+        Scheduler(int threads, TileOrder order = TileOrder::ORDER_MORTON,
+            int tileSize = 32);
+        void run(std::vector<Tile> tiles,
+            const std::function<void(const Tile &)> &task);
+        void report(std::ostream &out) const;
+        void sort(std::vector<Tile> &tiles) const;
+        static std::uint32_t mortonCode(int x, int y);
+
+      private:
+        void work(int index, const std::function<void(const Tile &)> &task);
+        bool pop(int index, Tile &tile);
+        bool steal(int index, Tile &tile);
+    };
+} // namespace Raytracer::Core
+
+#endif /* __SCHEDULER_HPP__ */
@@ -0,0 +1,25 @@
+#include "Common.hpp"
+
+#ifndef __TILE_HPP__
+    #define __TILE_HPP__
+
+namespace Raytracer::Core
+{
+    class Tile {
+      private:
+        int _x = 0;
+        int _y = 0;
+        int _width = 0;
+        int _height = 0;
+
+      public:
+        Tile() = default;
+        Tile(int x, int y, int width, int height);
+        GET_SET(int, x)
+        GET_SET(int, y)
+        GET_SET(int, width)
+        GET_SET(int, height)
+    };
+} // namespace Raytracer::Core
+
+#endif /* __TILE_HPP__ */
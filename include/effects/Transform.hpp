@@ -0,0 +1,33 @@
+#include <memory>
+#include "interfaces/IHittable.hpp"
+#include "utils/Affine.hpp"
+#include "utils/AxisAlignedBBox.hpp"
+
+#ifndef __TRANSFORM_HPP__
+    #define __TRANSFORM_HPP__
+
+namespace Raytracer::Effects
+{
+    class Transform : public Interfaces::IHittable {
+      private:
+        std::shared_ptr<Interfaces::IHittable> _object;
+        Utils::Affine _transform;
+        Utils::Affine _inverse;
+        Utils::AxisAlignedBBox _bbox;
+
+      public:
+        Transform(std::shared_ptr<Interfaces::IHittable> object,
+            const Utils::Affine &transform);
+        bool hit(const Core::Ray &ray, Utils::Interval interval,
+            Core::Payload &payload) const override;
+        Utils::AxisAlignedBBox boundingBox() const override;
+        bool emissive() const override;
+        double pdfValue(const Utils::Point3 &origin,
+            const Utils::Vec3 &direction) const override;
+        Utils::Vec3 random(const Utils::Point3 &origin) const override;
+        std::shared_ptr<Interfaces::IHittable> object() const;
+        const Utils::Affine &transform() const;
+    };
+} // namespace Raytracer::Effects
+
+#endif /* __TRANSFORM_HPP__ */
@@ -14,6 +14,19 @@ namespace Raytracer::Interfaces
         virtual bool hit(const Core::Ray &ray, Utils::Interval interval,
             Core::Payload &payload) const = 0;
         virtual Utils::AxisAlignedBBox boundingBox() const = 0;
+        virtual bool emissive() const
+        {
+            return false;
+        }
+        virtual double pdfValue(
+            const Utils::Point3 &origin, const Utils::Vec3 &direction) const
+        {
+            return 0.0;
+        }
+        virtual Utils::Vec3 random(const Utils::Point3 &origin) const
+        {
+            return Utils::Vec3(1, 0, 0);
+        }
     };
 } // namespace Raytracer::Interfaces
 
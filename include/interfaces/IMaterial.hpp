@@ -19,6 +19,15 @@ namespace Raytracer::Interfaces
         virtual bool scatter(const Core::Ray &ray,
             const Core::Payload &payload, Utils::Color &attenuation,
             Core::Ray &scattered) const = 0;
+        virtual double scatteringPdf(const Core::Ray &ray,
+            const Core::Payload &payload, const Core::Ray &scattered) const
+        {
+            return 0.0;
+        }
+        virtual bool emits() const
+        {
+            return false;
+        }
     };
 } // namespace Raytracer::Interfaces
 
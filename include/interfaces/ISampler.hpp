@@ -0,0 +1,16 @@
+#include <cstdint>
+
+#ifndef __ISAMPLER_HPP__
+    #define __ISAMPLER_HPP__
+
+namespace Raytracer::Interfaces
+{
+    class ISampler {
+      public:
+        virtual ~ISampler() = default;
+        virtual double value(std::uint64_t seed, int x, int y,
+            std::uint32_t index, std::uint32_t dimension) const = 0;
+    };
+} // namespace Raytracer::Interfaces
+
+#endif /* __ISAMPLER_HPP__ */
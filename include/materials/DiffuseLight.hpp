@@ -18,6 +18,7 @@ namespace Raytracer::Materials
             Utils::Color &attenuation, Core::Ray &scattered) const override;
         Utils::Color emitted(
             double u, double v, const Utils::Point3 &point) const override;
+        bool emits() const override;
     };
 } // namespace Raytracer::Materials
 
@@ -18,6 +18,9 @@ namespace Raytracer::Materials
             Utils::Color &attenuation, Core::Ray &scattered) const override;
         Utils::Color emitted(
             double u, double v, const Utils::Point3 &point) const override;
+        double scatteringPdf(const Core::Ray &ray,
+            const Core::Payload &payload,
+            const Core::Ray &scattered) const override;
     };
 } // namespace Raytracer::Materials
 
@@ -0,0 +1,23 @@
+#include <vector>
+#include "samplers/Sobol.hpp"
+
+#ifndef __BLUE_NOISE_HPP__
+    #define __BLUE_NOISE_HPP__
+
+namespace Raytracer::Samplers
+{
+    class BlueNoise : public Sobol {
+      public:
+        static constexpr int size = 64;
+
+        BlueNoise() = default;
+        double value(std::uint64_t seed, int x, int y, std::uint32_t index,
+            std::uint32_t dimension) const override;
+        static const std::vector<float> &mask();
+
+      private:
+        static std::vector<float> generate();
+    };
+} // namespace Raytracer::Samplers
+
+#endif /* __BLUE_NOISE_HPP__ */
@@ -0,0 +1,23 @@
+#include "interfaces/ISampler.hpp"
+
+#ifndef __SOBOL_HPP__
+    #define __SOBOL_HPP__
+
+namespace Raytracer::Samplers
+{
+    class Sobol : public Interfaces::ISampler {
+      public:
+        Sobol() = default;
+        double value(std::uint64_t seed, int x, int y, std::uint32_t index,
+            std::uint32_t dimension) const override;
+
+      protected:
+        static double sample(std::uint64_t seed, std::uint32_t index,
+            std::uint32_t dimension);
+        static std::uint32_t scramble(
+            std::uint32_t value, std::uint32_t seed);
+        static std::uint32_t reverse(std::uint32_t value);
+    };
+} // namespace Raytracer::Samplers
+
+#endif /* __SOBOL_HPP__ */
@@ -0,0 +1,16 @@
+#include "interfaces/ISampler.hpp"
+
+#ifndef __UNIFORM_HPP__
+    #define __UNIFORM_HPP__
+
+namespace Raytracer::Samplers
+{
+    class Uniform : public Interfaces::ISampler {
+      public:
+        Uniform() = default;
+        double value(std::uint64_t seed, int x, int y, std::uint32_t index,
+            std::uint32_t dimension) const override;
+    };
+} // namespace Raytracer::Samplers
+
+#endif /* __UNIFORM_HPP__ */
@@ -0,0 +1,33 @@
+#include <memory>
+#include <vector>
+#include "interfaces/IHittable.hpp"
+#include "utils/MeshData.hpp"
+#include "utils/VecN.hpp"
+
+#ifndef __MESH_HPP__
+    #define __MESH_HPP__
+
+namespace Raytracer::Shapes
+{
+    class Mesh : public Interfaces::IHittable {
+      private:
+        std::shared_ptr<const Utils::MeshData> _data;
+        double _scale;
+        std::shared_ptr<Interfaces::IMaterial> _material;
+        Utils::AxisAlignedBBox _bbox;
+        std::vector<double> _areas;
+
+      public:
+        Mesh(std::shared_ptr<const Utils::MeshData> data, double scale,
+            std::shared_ptr<Interfaces::IMaterial> material);
+        bool hit(const Core::Ray &ray, Utils::Interval interval,
+            Core::Payload &payload) const override;
+        Utils::AxisAlignedBBox boundingBox() const override;
+        bool emissive() const override;
+        double pdfValue(const Utils::Point3 &origin,
+            const Utils::Vec3 &direction) const override;
+        Utils::Vec3 random(const Utils::Point3 &origin) const override;
+    };
+} // namespace Raytracer::Shapes
+
+#endif /* __MESH_HPP__ */
@@ -17,6 +17,7 @@ namespace Raytracer::Shapes
         Utils::AxisAlignedBBox _bbox;
         Utils::Vec3 _normal;
         double _D;
+        double _area;
 
       public:
         Quad(const Utils::Point3 &Q, const Utils::Vec3 &u,
@@ -25,6 +26,10 @@ namespace Raytracer::Shapes
         bool hit(const Core::Ray &ray, Utils::Interval interval,
             Core::Payload &payload) const override;
         Utils::AxisAlignedBBox boundingBox() const override;
+        bool emissive() const override;
+        double pdfValue(const Utils::Point3 &origin,
+            const Utils::Vec3 &direction) const override;
+        Utils::Vec3 random(const Utils::Point3 &origin) const override;
         virtual void setBBox();
         virtual bool isInterior(
             double a, double b, Core::Payload &payload) const;
@@ -25,6 +25,10 @@ namespace Raytracer::Shapes
             Core::Payload &hit) const override;
         Utils::Point3 sphereCenter(double time) const;
         Utils::AxisAlignedBBox boundingBox() const override;
+        bool emissive() const override;
+        double pdfValue(const Utils::Point3 &origin,
+            const Utils::Vec3 &direction) const override;
+        Utils::Vec3 random(const Utils::Point3 &origin) const override;
         static void getSphereUV(
             const Utils::Point3 &point, double &u, double &v);
     };
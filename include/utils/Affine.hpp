@@ -0,0 +1,29 @@
+#include "utils/AxisAlignedBBox.hpp"
+#include "utils/VecN.hpp"
+
+#ifndef __AFFINE_HPP__
+    #define __AFFINE_HPP__
+
+namespace Raytracer::Utils
+{
+    class Affine {
+      private:
+        double _m[3][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}};
+
+      public:
+        Affine() = default;
+        static Affine translation(const Vec3 &offset);
+        static Affine rotation(int axis, double angle);
+        static Affine scaling(const Vec3 &factors);
+        Affine operator*(const Affine &other) const;
+        Affine inverse() const;
+        double determinant() const;
+        bool similarity() const;
+        Point3 point(const Point3 &p) const;
+        Vec3 vector(const Vec3 &v) const;
+        Vec3 transposed(const Vec3 &v) const;
+        AxisAlignedBBox box(const AxisAlignedBBox &bbox) const;
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __AFFINE_HPP__ */
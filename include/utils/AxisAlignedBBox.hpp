@@ -22,6 +22,8 @@ namespace Raytracer::Utils
         const Interval &axisInterval(int n) const;
         bool hit(const Core::Ray &ray, Interval interval) const;
         int longestAxis() const;
+        double surfaceArea() const;
+        Point3 centroid() const;
         void padToMinimum();
         static const AxisAlignedBBox Empty;
         static const AxisAlignedBBox Universe;
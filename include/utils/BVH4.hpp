@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "interfaces/IHittable.hpp"
+#include "utils/BVHNode.hpp"
+
+#ifndef __BVH4_HPP__
+    #define __BVH4_HPP__
+
+namespace Raytracer::Utils
+{
+    class BVH4 : public Interfaces::IHittable {
+      private:
+        struct alignas(16) Node {
+            float min[3][4];
+            float max[3][4];
+            std::int32_t child[4];
+            std::uint16_t count[4];
+            std::uint8_t valid;
+        };
+
+        struct Entry {
+            std::int32_t child;
+            std::uint16_t count;
+            float t;
+        };
+
+        std::vector<Node> _nodes;
+        std::vector<std::shared_ptr<Interfaces::IHittable>> _primitives;
+        AxisAlignedBBox _bbox;
+        std::size_t _depth = 0;
+
+      public:
+        static constexpr std::size_t stackSize = 192;
+
+        BVH4() = default;
+        BVH4(const BVHNode &root);
+        bool hit(const Core::Ray &ray, Interval interval,
+            Core::Payload &payload) const override;
+        AxisAlignedBBox boundingBox() const override;
+        std::size_t nodeCount() const;
+
+      private:
+        std::int32_t flatten(const BVHNode &node, std::size_t depth);
+        static bool interior(
+            const std::shared_ptr<Interfaces::IHittable> &object);
+        static int slab(const Node &node, const float lower[3],
+            const float upper[3], const float inverse[3], float tmin,
+            float tmax,
+            float distances[4]);
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __BVH4_HPP__ */
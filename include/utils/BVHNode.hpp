@@ -1,5 +1,8 @@
+#include <functional>
+#include <unordered_map>
 #include "core/Scene.hpp"
 #include "interfaces/IHittable.hpp"
+#include "utils/BVHSettings.hpp"
 
 #ifndef __BVH_NODE_HPP__
     #define __BVH_NODE_HPP__
@@ -11,15 +14,38 @@ namespace Raytracer::Utils
         std::shared_ptr<Interfaces::IHittable> _left;
         std::shared_ptr<Interfaces::IHittable> _right;
         AxisAlignedBBox _bbox;
+        double _cost = 0;
+        int _axis = 0;
 
       public:
+        using Replacements =
+            std::unordered_map<const Interfaces::IHittable *,
+                std::shared_ptr<Interfaces::IHittable>>;
+
+        static constexpr double traversalCost = 0.125;
+        static constexpr double intersectionCost = 1.0;
+        static constexpr std::size_t parallelThreshold = 4096;
+
         BVHNode() = default;
         BVHNode(Core::Scene list);
+        BVHNode(Core::Scene list, const BVHSettings &settings);
         BVHNode(std::vector<std::shared_ptr<Interfaces::IHittable>> &objects,
             size_t start, size_t end);
+        BVHNode(std::vector<std::shared_ptr<Interfaces::IHittable>> &objects,
+            size_t start, size_t end, const BVHSettings &settings);
         bool hit(const Core::Ray &ray, Interval interval,
             Core::Payload &payload) const override;
         AxisAlignedBBox boundingBox() const override;
+        double sahCost() const;
+        std::shared_ptr<BVHNode> refit(
+            const Replacements &replacements) const;
+        static size_t splitSAH(
+            std::vector<std::shared_ptr<Interfaces::IHittable>> &objects,
+            size_t start, size_t end, int bins, int threads, double &cost,
+            int &splitAxis);
+        static size_t splitMedian(
+            std::vector<std::shared_ptr<Interfaces::IHittable>> &objects,
+            size_t start, size_t end, int &axis, int threads = 1);
         static bool boxCompare(const std::shared_ptr<Interfaces::IHittable> &a,
             const std::shared_ptr<Interfaces::IHittable> &b, int axis);
         static bool boxXCompare(
@@ -33,6 +59,12 @@ namespace Raytracer::Utils
             const std::shared_ptr<Interfaces::IHittable> &b);
         GET_SET(std::shared_ptr<Interfaces::IHittable>, left)
         GET_SET(std::shared_ptr<Interfaces::IHittable>, right)
+        GET_SET(int, axis)
+
+      private:
+        void finish();
+        static void parallelFor(size_t start, size_t end, int chunks,
+            const std::function<void(int, std::size_t, std::size_t)> &fn);
     };
 } // namespace Raytracer::Utils
 
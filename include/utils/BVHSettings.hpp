@@ -0,0 +1,37 @@
+#include "Common.hpp"
+
+#ifndef __BVH_SETTINGS_HPP__
+    #define __BVH_SETTINGS_HPP__
+
+namespace Raytracer::Utils
+{
+    enum class BVHBuilder {
+        BUILDER_MEDIAN,
+        BUILDER_SAH,
+    };
+
+    enum class BVHLayout {
+        LAYOUT_TREE,
+        LAYOUT_LINEAR,
+        LAYOUT_BVH4,
+    };
+
+    class BVHSettings {
+      private:
+        BVHBuilder _builder = BVHBuilder::BUILDER_SAH;
+        BVHLayout _layout = BVHLayout::LAYOUT_LINEAR;
+        int _leafSize = 4;
+        int _bins = 16;
+        int _threads = 1;
+
+      public:
+        BVHSettings() = default;
+        GET_SET(BVHBuilder, builder)
+        GET_SET(BVHLayout, layout)
+        GET_SET(int, leafSize)
+        GET_SET(int, bins)
+        GET_SET(int, threads)
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __BVH_SETTINGS_HPP__ */
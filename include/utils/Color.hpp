@@ -1,3 +1,6 @@
+#include <cstdint>
+#include <ostream>
+#include <vector>
 #include "VecN.hpp"
 
 #ifndef __COLOR_HPP__
@@ -6,7 +9,13 @@
 namespace Raytracer::Utils
 {
     double linearToGamma(double linear);
-    void writeColor(std::ostream &out, const Color &pixelColor);
+    std::uint8_t toByte(double linear);
+    void writePPM(std::ostream &out, int width, int height,
+        const std::vector<Color> &framebuffer);
+    void writePFM(std::ostream &out, int width, int height,
+        const std::vector<Color> &framebuffer);
+    void writeEXR(std::ostream &out, int width, int height,
+        const std::vector<Color> &framebuffer);
 } // namespace Raytracer::Utils
 
 #endif /* __COLOR_HPP__ */
@@ -0,0 +1,19 @@
+#include <cstdint>
+
+#ifndef __COUNTERS_HPP__
+    #define __COUNTERS_HPP__
+
+namespace Raytracer::Utils
+{
+    class Counters {
+      private:
+        Counters() = delete;
+
+      public:
+        static thread_local std::uint64_t rays;
+        static thread_local std::uint64_t nodes;
+        static void reset();
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __COUNTERS_HPP__ */
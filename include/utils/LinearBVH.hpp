@@ -0,0 +1,47 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "interfaces/IHittable.hpp"
+#include "utils/BVHNode.hpp"
+
+#ifndef __LINEAR_BVH_HPP__
+    #define __LINEAR_BVH_HPP__
+
+namespace Raytracer::Utils
+{
+    class LinearBVH : public Interfaces::IHittable {
+      private:
+        struct Node {
+            float min[3];
+            float max[3];
+            std::int32_t offset;
+            std::uint16_t count;
+            std::uint8_t axis;
+            std::uint8_t padding;
+        };
+
+        static_assert(sizeof(Node) == 32, "LinearBVH nodes must be 32 bytes");
+
+        std::vector<Node> _nodes;
+        std::vector<std::shared_ptr<Interfaces::IHittable>> _primitives;
+        AxisAlignedBBox _bbox;
+        std::size_t _depth = 0;
+
+      public:
+        static constexpr std::size_t stackSize = 64;
+
+        LinearBVH() = default;
+        LinearBVH(const BVHNode &root);
+        bool hit(const Core::Ray &ray, Interval interval,
+            Core::Payload &payload) const override;
+        AxisAlignedBBox boundingBox() const override;
+        std::size_t nodeCount() const;
+
+      private:
+        std::int32_t flatten(const BVHNode &node, std::size_t depth);
+        static bool slab(const Node &node, const Point3 &origin,
+            const Vec3 &inverse, const Interval &interval);
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __LINEAR_BVH_HPP__ */
@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/Ray.hpp"
+#include "utils/AxisAlignedBBox.hpp"
+#include "utils/Interval.hpp"
+#include "utils/VecN.hpp"
+
+#ifndef __MESH_DATA_HPP__
+    #define __MESH_DATA_HPP__
+
+namespace Raytracer::Utils
+{
+    class MeshData {
+      public:
+        struct Hit {
+            std::uint32_t triangle;
+            double t;
+            double b1;
+            double b2;
+        };
+
+      private:
+        struct Node {
+            float min[3];
+            float max[3];
+            std::int32_t offset;
+            std::uint16_t count;
+            std::uint8_t axis;
+            std::uint8_t padding;
+        };
+
+        static_assert(sizeof(Node) == 32, "MeshData nodes must be 32 bytes");
+
+        struct Bounds {
+            float min[3];
+            float max[3];
+        };
+
+        struct Buffers {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+            std::vector<float> nx;
+            std::vector<float> ny;
+            std::vector<float> nz;
+            std::vector<float> tu;
+            std::vector<float> tv;
+            std::vector<std::uint32_t> indices;
+            std::vector<std::uint32_t> normalIndices;
+            std::vector<std::uint32_t> uvIndices;
+            std::vector<Node> nodes;
+        };
+
+        struct CacheHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t depth;
+            std::uint64_t hash;
+            std::uint64_t vertices;
+            std::uint64_t normals;
+            std::uint64_t uvs;
+            std::uint64_t triangles;
+            std::uint64_t normalIndices;
+            std::uint64_t uvIndices;
+            std::uint64_t nodes;
+        };
+
+        static std::string _cacheDirectory;
+
+        std::shared_ptr<const void> _storage;
+        std::span<const float> _x;
+        std::span<const float> _y;
+        std::span<const float> _z;
+        std::span<const float> _nx;
+        std::span<const float> _ny;
+        std::span<const float> _nz;
+        std::span<const float> _tu;
+        std::span<const float> _tv;
+        std::span<const std::uint32_t> _indices;
+        std::span<const std::uint32_t> _normalIndices;
+        std::span<const std::uint32_t> _uvIndices;
+        std::span<const Node> _nodes;
+        std::size_t _depth = 0;
+        AxisAlignedBBox _bbox;
+
+      public:
+        static constexpr std::uint32_t none = UINT32_MAX;
+        static constexpr std::size_t leafSize = 4;
+        static constexpr int bins = 16;
+        static constexpr std::size_t stackSize = 64;
+        static constexpr std::uint32_t cacheVersion = 1;
+
+        MeshData() = default;
+        static std::shared_ptr<const MeshData> load(const std::string &path);
+        static void cacheDirectory(const std::string &path);
+        static const std::string &cacheDirectory();
+        bool intersect(
+            const Core::Ray &ray, Interval interval, Hit &hit) const;
+        std::size_t triangleCount() const;
+        Point3 vertex(std::uint32_t triangle, int corner) const;
+        std::optional<Vec3> normal(const Hit &hit) const;
+        std::optional<std::pair<double, double>> uv(const Hit &hit) const;
+        AxisAlignedBBox boundingBox() const;
+
+      private:
+        static void parse(const std::string &path, const char *begin,
+            const char *end, Buffers &buffers);
+        void build(Buffers &buffers);
+        void use(const std::shared_ptr<const Buffers> &buffers);
+        bool readCache(const std::string &path, std::uint64_t hash);
+        void writeCache(const std::string &path, std::uint64_t hash) const;
+        bool validate(std::size_t depth) const;
+        std::int32_t build(std::vector<Node> &nodes,
+            std::vector<std::uint32_t> &order,
+            const std::vector<Bounds> &bounds, std::size_t start,
+            std::size_t end, std::size_t depth);
+        static double area(const float min[3], const float max[3]);
+        static bool slab(const Node &node, const Point3 &origin,
+            const Vec3 &inverse, const Interval &interval);
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __MESH_DATA_HPP__ */
@@ -0,0 +1,29 @@
+#include <cstdint>
+#include "Common.hpp"
+
+#ifndef __RANDOM_HPP__
+    #define __RANDOM_HPP__
+
+namespace Raytracer::Utils
+{
+    class Random {
+      private:
+        std::uint64_t _state = 0x853c49e6748fea9bULL;
+        std::uint64_t _increment = 0xda3e39cb94b95bdbULL;
+
+      public:
+        Random() = default;
+        Random(std::uint64_t seed, std::uint64_t stream = 0);
+        void seed(std::uint64_t seed, std::uint64_t stream = 0);
+        void seed(std::uint64_t seed, std::uint64_t pixel,
+            std::uint64_t sample);
+        std::uint32_t next();
+        double nextDouble();
+        static Random &local();
+        static std::uint64_t mix(std::uint64_t value);
+        GET_SET(std::uint64_t, state)
+        GET_SET(std::uint64_t, increment)
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __RANDOM_HPP__ */
@@ -0,0 +1,34 @@
+#include <cstdint>
+#include "utils/Random.hpp"
+
+#ifndef __SAMPLER_HPP__
+    #define __SAMPLER_HPP__
+
+namespace Raytracer::Interfaces
+{
+    class ISampler;
+} // namespace Raytracer::Interfaces
+
+namespace Raytracer::Utils
+{
+    class Sampler {
+      private:
+        const Interfaces::ISampler *_sampler = nullptr;
+        std::uint64_t _seed = 0;
+        int _x = 0;
+        int _y = 0;
+        std::uint32_t _index = 0;
+        std::uint32_t _dimension = 0;
+        std::uint32_t _end = 0;
+
+      public:
+        Sampler() = default;
+        void start(const Interfaces::ISampler *sampler, std::uint64_t seed,
+            int x, int y, std::uint32_t index);
+        void dimensions(std::uint32_t first, std::uint32_t count);
+        double next();
+        static Sampler &local();
+    };
+} // namespace Raytracer::Utils
+
+#endif /* __SAMPLER_HPP__ */
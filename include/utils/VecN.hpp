@@ -2,6 +2,7 @@
 #include <cstddef>
 #include <iostream>
 #include "exceptions/Range.hpp"
+#include "utils/Sampler.hpp"
 #include <type_traits>
 
 #ifndef __VEC_N_HPP__
@@ -16,7 +17,7 @@ namespace Raytracer::Utils
 
     inline double randomDouble()
     {
-        return rand() / (RAND_MAX + 1.0);
+        return Sampler::local().next();
     }
 
     inline double randomDouble(double min, double max)
@@ -286,7 +287,15 @@ namespace Raytracer::Utils
 
     template <typename T, std::size_t N> VecN<T, N> randomUnitVector()
     {
-        return unitVector(randomInUnitSphere<T, N>());
+        if constexpr (N == 3) {
+            double z = 1 - 2 * randomDouble();
+            double r = std::sqrt(std::fmax(0.0, 1 - z * z));
+            double phi = 2 * M_PI * randomDouble();
+
+            return VecN<T, N>(r * std::cos(phi), r * std::sin(phi), z);
+        } else {
+            return unitVector(randomInUnitSphere<T, N>());
+        }
     }
 
     template <typename T, std::size_t N>
@@ -320,15 +329,19 @@ namespace Raytracer::Utils
 
     template <typename T, std::size_t N> VecN<T, N> randomInUnitDisk()
     {
-        while (true) {
-            VecN<T, N> p =
-                VecN<T, N>(randomDouble(-1, 1), randomDouble(-1, 1), 0);
-            if (p.lengthSquared() >= 1) {
-                continue;
-            }
+        double a = randomDouble(-1, 1);
+        double b = randomDouble(-1, 1);
 
-            return p;
+        if (a == 0 && b == 0) {
+            return VecN<T, N>(0, 0, 0);
         }
+
+        double r = (std::fabs(a) > std::fabs(b)) ? a : b;
+        double phi = (std::fabs(a) > std::fabs(b))
+            ? (M_PI / 4) * (b / a)
+            : (M_PI / 2) - (M_PI / 4) * (a / b);
+
+        return VecN<T, N>(r * std::cos(phi), r * std::sin(phi), 0);
     }
 } // namespace Raytracer::Utils
 
@@ -0,0 +1,371 @@
+#include "config/Daemon.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Construct a new Daemon object
+ *
+ * Create a daemon listening on the Unix domain socket at the given path. The
+ * thread count, tile order, worker processes, statistics and seed of the
+ * given camera are applied to every scene the daemon loads.
+ *
+ * @param path Path of the Unix domain socket
+ * @param defaults Camera holding the command line settings
+ */
+Raytracer::Config::Daemon::Daemon(
+    const std::string &path, const Core::Camera &defaults)
+    : _path(path), _defaults(defaults)
+{
+}
+
+/**
+ * @brief Serve render jobs
+ *
+ * Listen on the Unix domain socket and serve the render jobs sent to it, one
+ * connection at a time. The socket is only accessible to the user running
+ * the daemon, and connections from processes of other users are refused,
+ * since a job reads and writes files with the rights of the daemon. A job is
+ * a list of `key value` lines ended by an empty line or by the end of the
+ * connection, and must be sent within `receiveTimeout` seconds so that a
+ * stalled client does not hold up the jobs queued behind it. It must hold
+ * the `config` path of the scene and the `output` path of the image, and may
+ * override the `width`, `samples`, `depth`, `seed`, `threads`, `v_fov`,
+ * `look_from` and `look_at` of the camera. The daemon answers with a single
+ * line, `OK` followed by the render time in seconds and whether the scene
+ * was cached, or `ERROR` followed by the reason of the failure.
+ *
+ * @return false if the socket could not be set up, the daemon runs forever
+ * otherwise
+ */
+bool Raytracer::Config::Daemon::run()
+{
+    sockaddr_un address = {};
+
+    if (_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "ERROR: Socket path '" << _path << "' is too long"
+                  << std::endl;
+        return false;
+    }
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(
+        address.sun_path, _path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(_path.c_str());
+
+    mode_t mask = umask(0177);
+    bool bound = server >= 0
+        && bind(server, reinterpret_cast<sockaddr *>(&address),
+               sizeof(address))
+            == 0;
+
+    umask(mask);
+    if (!bound || listen(server, 16) < 0) {
+        std::cerr << "ERROR: Could not listen on socket '" << _path << "'"
+                  << std::endl;
+        if (server >= 0) {
+            close(server);
+        }
+        return false;
+    }
+
+    std::clog << "Listening on " << _path << std::endl;
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        std::string response = trusted(client)
+            ? receive(client)
+            : "ERROR permission denied\n";
+
+        send(client, response.data(), response.size(), MSG_NOSIGNAL);
+        close(client);
+    }
+
+    std::cerr << "ERROR: Could not accept on socket '" << _path << "'"
+              << std::endl;
+    close(server);
+    unlink(_path.c_str());
+
+    return false;
+}
+
+/**
+ * @brief Check the owner of a connection
+ *
+ * Check that the process on the other end of the given connection runs as
+ * the same user as the daemon.
+ *
+ * @param client Socket of the connection
+ *
+ * @return true if the connection comes from the same user, false otherwise
+ */
+bool Raytracer::Config::Daemon::trusted(int client)
+{
+    ucred credentials = {};
+    socklen_t length = sizeof(credentials);
+
+    return getsockopt(
+               client, SOL_SOCKET, SO_PEERCRED, &credentials, &length)
+        == 0
+        && credentials.uid == geteuid();
+}
+
+/**
+ * @brief Receive and handle a render job
+ *
+ * Read the lines of a job from the given connection until the empty line
+ * ending it or the end of the connection, giving up if the client sends
+ * nothing for `receiveTimeout` seconds, then handle the job.
+ *
+ * @param client Socket of the connection
+ *
+ * @return std::string Response to send back
+ */
+std::string Raytracer::Config::Daemon::receive(int client)
+{
+    timeval timeout = {receiveTimeout, 0};
+    std::string request;
+    char buffer[4096];
+    ssize_t size = 0;
+
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    while (request.find("\n\n") == std::string::npos
+        && (size = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+        request.append(buffer, size);
+    }
+    if (size < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK
+            ? "ERROR timed out\n"
+            : "ERROR could not receive the job\n";
+    }
+
+    return handle(request);
+}
+
+/**
+ * @brief Handle a render job
+ *
+ * Load the scene of the job, or reuse it if it is cached, reset its camera to
+ * the settings of the scene file, apply the overrides of the job and render
+ * the image to the output path of the job.
+ *
+ * @param request Lines of the job
+ *
+ * @return std::string Response to send back
+ */
+std::string Raytracer::Config::Daemon::handle(const std::string &request)
+{
+    std::istringstream lines(request);
+    std::string line;
+    std::string config;
+    std::string output;
+    std::vector<std::pair<std::string, std::string>> overrides;
+
+    while (std::getline(lines, line) && !line.empty()) {
+        std::size_t space = line.find(' ');
+        std::string key = line.substr(0, space);
+        std::string value =
+            space == std::string::npos ? "" : line.substr(space + 1);
+
+        if (key == "config") {
+            config = value;
+        } else if (key == "output") {
+            output = value;
+        } else {
+            overrides.emplace_back(key, value);
+        }
+    }
+
+    if (config.empty() || output.empty()) {
+        return "ERROR missing config or output\n";
+    }
+
+    bool cached = false;
+    Entry *entry = load(config, cached);
+
+    if (!entry) {
+        return std::format("ERROR could not load scene '{}'\n", config);
+    }
+
+    Core::Camera &camera = entry->manager->camera();
+
+    camera = entry->camera;
+    for (const auto &[key, value] : overrides) {
+        std::istringstream stream(value);
+
+        if (!override(camera, key, stream)) {
+            return std::format("ERROR invalid override '{}'\n", key);
+        }
+    }
+    camera.output(output);
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!entry->manager->render(false)) {
+        return "ERROR render failed\n";
+    }
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::clog << std::endl;
+
+    return std::format(
+        "OK {:.3f} {}\n", elapsed.count(), cached ? "cached" : "loaded");
+}
+
+/**
+ * @brief Load a scene
+ *
+ * Return the cached scene of the given config file if the file has not been
+ * modified since it was loaded. Otherwise, parse the file again, reusing the
+ * unchanged objects of the previous load, apply the command line settings to
+ * its camera and cache the result along with the modification time of the
+ * file. The previous load stays cached until the file parses again, so that
+ * a config saved with an error does not drop a scene that rendered. The BVH
+ * of a cached scene is built, or refitted from the previous load, on its
+ * first render and kept until the scene is reloaded.
+ *
+ * @param path Path of the config file
+ * @param cached Set to true if the cached scene was reused
+ *
+ * @return Entry* Cached scene, or nullptr if the file could not be loaded
+ */
+Raytracer::Config::Daemon::Entry *Raytracer::Config::Daemon::load(
+    const std::string &path, bool &cached)
+{
+    std::error_code error;
+    std::string key = std::filesystem::weakly_canonical(path, error).string();
+    std::filesystem::file_time_type time =
+        std::filesystem::last_write_time(key, error);
+
+    if (error) {
+        return nullptr;
+    }
+
+    auto it = _scenes.find(key);
+
+    if (it != _scenes.end() && it->second.time == time) {
+        cached = true;
+        return &it->second;
+    }
+
+    std::unique_ptr<Manager> manager = std::make_unique<Manager>();
+
+    if (it != _scenes.end()) {
+        manager->reuse(*it->second.manager);
+    }
+    if (!manager->parse(key)) {
+        return nullptr;
+    }
+
+    Core::Camera &camera = manager->camera();
+
+    camera.threads(_defaults.threads());
+    camera.tileOrder(_defaults.tileOrder());
+    camera.processes(_defaults.processes());
+    camera.statistics(_defaults.statistics());
+    camera.seed(_defaults.seed());
+    manager->bootstrap();
+
+    Entry &entry = _scenes[key];
+
+    entry.camera = camera;
+    entry.manager = std::move(manager);
+    entry.time = time;
+    cached = false;
+
+    return &entry;
+}
+
+/**
+ * @brief Apply a camera override
+ *
+ * Set the camera setting matching the given key of a render job to the
+ * given value.
+ *
+ * @param camera Camera to update
+ * @param key Name of the setting
+ * @param value Value of the setting
+ *
+ * @return true if the setting was applied, false if the key is unknown or
+ * the value is invalid
+ */
+bool Raytracer::Config::Daemon::override(
+    Core::Camera &camera, const std::string &key, std::istringstream &value)
+{
+    if (key == "width" || key == "samples" || key == "depth"
+        || key == "threads") {
+        int number = 0;
+
+        if (!(value >> number) || number < 1) {
+            return false;
+        }
+        if (key == "width") {
+            camera.imageWidth(number);
+        } else if (key == "samples") {
+            camera.samplesPerPixel(number);
+        } else if (key == "depth") {
+            camera.maxDepth(number);
+        } else {
+            camera.threads(number);
+        }
+        return true;
+    }
+
+    if (key == "seed") {
+        std::uint64_t seed = 0;
+
+        if (!(value >> seed)) {
+            return false;
+        }
+        camera.seed(seed);
+        return true;
+    }
+
+    if (key == "v_fov") {
+        double fov = 0;
+
+        if (!(value >> fov) || fov <= 0 || fov >= 180) {
+            return false;
+        }
+        camera.vFov(fov);
+        return true;
+    }
+
+    if (key == "look_from" || key == "look_at") {
+        double x = 0;
+        double y = 0;
+        double z = 0;
+
+        if (!(value >> x >> y >> z)) {
+            return false;
+        }
+        if (key == "look_from") {
+            camera.lookFrom(Utils::Point3(x, y, z));
+        } else {
+            camera.lookAt(Utils::Point3(x, y, z));
+        }
+        return true;
+    }
+
+    return false;
+}
@@ -4,11 +4,8 @@
 #include "arguments/Materials.hpp"
 #include "arguments/Shapes.hpp"
 #include "arguments/Textures.hpp"
-#include "effects/RotateX.hpp"
-#include "effects/RotateY.hpp"
-#include "effects/RotateZ.hpp"
 #include "effects/Smoke.hpp"
-#include "effects/Translate.hpp"
+#include "effects/Transform.hpp"
 #include "interfaces/IArguments.hpp"
 #include "materials/Dielectric.hpp"
 #include "materials/DiffuseLight.hpp"
@@ -17,6 +14,7 @@
 #include "materials/Metal.hpp"
 #include "shapes/Cone.hpp"
 #include "shapes/Cylinder.hpp"
+#include "shapes/Mesh.hpp"
 #include "shapes/Plane.hpp"
 #include "shapes/Quad.hpp"
 #include "shapes/Sphere.hpp"
@@ -107,9 +105,10 @@ Raytracer::Config::FactoryMap<Raytracer::Interfaces::IHittable,
             [](std::shared_ptr<Interfaces::IArguments> raw) {
                 std::shared_ptr<Arguments::RotateX> args =
                     std::dynamic_pointer_cast<Arguments::RotateX>(raw);
-                std::shared_ptr<Raytracer::Effects::RotateX> effect =
-                    std::make_shared<Raytracer::Effects::RotateX>(
-                        args->object(), args->angle());
+                std::shared_ptr<Raytracer::Effects::Transform> effect =
+                    std::make_shared<Raytracer::Effects::Transform>(
+                        args->object(),
+                        Utils::Affine::rotation(0, args->angle()));
 
                 return effect;
             },
@@ -119,9 +118,10 @@ Raytracer::Config::FactoryMap<Raytracer::Interfaces::IHittable,
             [](std::shared_ptr<Interfaces::IArguments> raw) {
                 std::shared_ptr<Arguments::RotateY> args =
                     std::dynamic_pointer_cast<Arguments::RotateY>(raw);
-                std::shared_ptr<Raytracer::Effects::RotateY> effect =
-                    std::make_shared<Raytracer::Effects::RotateY>(
-                        args->object(), args->angle());
+                std::shared_ptr<Raytracer::Effects::Transform> effect =
+                    std::make_shared<Raytracer::Effects::Transform>(
+                        args->object(),
+                        Utils::Affine::rotation(1, args->angle()));
 
                 return effect;
             },
@@ -131,9 +131,10 @@ Raytracer::Config::FactoryMap<Raytracer::Interfaces::IHittable,
             [](std::shared_ptr<Interfaces::IArguments> raw) {
                 std::shared_ptr<Arguments::RotateZ> args =
                     std::dynamic_pointer_cast<Arguments::RotateZ>(raw);
-                std::shared_ptr<Raytracer::Effects::RotateZ> effect =
-                    std::make_shared<Raytracer::Effects::RotateZ>(
-                        args->object(), args->angle());
+                std::shared_ptr<Raytracer::Effects::Transform> effect =
+                    std::make_shared<Raytracer::Effects::Transform>(
+                        args->object(),
+                        Utils::Affine::rotation(2, args->angle()));
 
                 return effect;
             },
@@ -143,9 +144,10 @@ Raytracer::Config::FactoryMap<Raytracer::Interfaces::IHittable,
             [](std::shared_ptr<Interfaces::IArguments> raw) {
                 std::shared_ptr<Arguments::Translate> args =
                     std::dynamic_pointer_cast<Arguments::Translate>(raw);
-                std::shared_ptr<Raytracer::Effects::Translate> effect =
-                    std::make_shared<Raytracer::Effects::Translate>(
-                        args->object(), args->offset());
+                std::shared_ptr<Raytracer::Effects::Transform> effect =
+                    std::make_shared<Raytracer::Effects::Transform>(
+                        args->object(),
+                        Utils::Affine::translation(args->offset()));
 
                 return effect;
             },
@@ -368,4 +370,29 @@ Raytracer::Config::FactoryMap<Raytracer::Interfaces::IHittable,
                 return shape;
             },
         },
+        {
+            "mesh",
+            [](std::shared_ptr<Interfaces::IArguments> raw) {
+                std::shared_ptr<Arguments::Mesh> args =
+                    std::dynamic_pointer_cast<Arguments::Mesh>(raw);
+                std::shared_ptr<Raytracer::Shapes::Mesh> shape =
+                    std::make_shared<Raytracer::Shapes::Mesh>(
+                        Utils::MeshData::load(args->path()), args->scale(),
+                        args->material());
+
+                return shape;
+            },
+        },
+        {
+            "instance",
+            [](std::shared_ptr<Interfaces::IArguments> raw) {
+                std::shared_ptr<Arguments::Instance> args =
+                    std::dynamic_pointer_cast<Arguments::Instance>(raw);
+                std::shared_ptr<Raytracer::Effects::Transform> shape =
+                    std::make_shared<Raytracer::Effects::Transform>(
+                        args->object(), args->transform());
+
+                return shape;
+            },
+        },
 };
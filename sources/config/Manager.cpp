@@ -1,9 +1,16 @@
 #include "config/Manager.hpp"
 #include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <format>
+#include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
+#include <iterator>
 #include <libconfig.hh>
 #include <memory>
 #include <optional>
@@ -14,13 +21,20 @@
 #include "arguments/Shapes.hpp"
 #include "arguments/Textures.hpp"
 #include "config/Factory.hpp"
+#include "effects/Transform.hpp"
 #include "exceptions/Argument.hpp"
 #include "exceptions/Cyclic.hpp"
 #include "exceptions/File.hpp"
 #include "exceptions/Missing.hpp"
 #include "exceptions/Parse.hpp"
 #include "interfaces/IArguments.hpp"
+#include "samplers/BlueNoise.hpp"
+#include "samplers/Sobol.hpp"
+#include "samplers/Uniform.hpp"
+#include "utils/BVH4.hpp"
 #include "utils/BVHNode.hpp"
+#include "utils/Counters.hpp"
+#include "utils/LinearBVH.hpp"
 #include "utils/VecN.hpp"
 #include "libconfig.h++"
 #include <type_traits>
@@ -417,6 +431,52 @@ Raytracer::Config::Manager::Manager()
                 return argument;
             },
         },
+        {
+            "mesh",
+            [this](libconfig::Setting &args) {
+                std::string path = args["path"];
+                double scale = args.exists("scale")
+                    ? static_cast<double>(args["scale"])
+                    : 1.0;
+                std::shared_ptr<Interfaces::IMaterial> material =
+                    retrieve<Interfaces::IMaterial>(
+                        args, _materials, "material");
+
+                if (!std::filesystem::exists(path)) {
+                    throw Exceptions::FileException(
+                        std::format("file `{}` not found", path));
+                }
+
+                if (scale <= 0) {
+                    throw Exceptions::ArgumentException(
+                        "mesh scale must be positive");
+                }
+
+                std::shared_ptr<Interfaces::IArguments> argument =
+                    std::make_shared<Arguments::Mesh>(path, scale, material);
+
+                return argument;
+            },
+        },
+        {
+            "instance",
+            [this](libconfig::Setting &args) {
+                std::shared_ptr<Interfaces::IHittable> hittable =
+                    retrieve<Interfaces::IHittable>(args, _shapes, "target");
+                Utils::Affine transform = parseTransform(args);
+
+                if (std::isinf(hittable->boundingBox().surfaceArea())) {
+                    throw Exceptions::ArgumentException(
+                        "instance target must be bounded");
+                }
+
+                std::shared_ptr<Interfaces::IArguments> argument =
+                    std::make_shared<Arguments::Instance>(
+                        bottomLevel(hittable), transform);
+
+                return argument;
+            },
+        },
     };
     _cameraMap = {
         {
@@ -480,15 +540,70 @@ Raytracer::Config::Manager::Manager()
                 camera.defocusAngle(std::get<double>(value));
             },
         },
+        {
+            "integrator",
+            [](Raytracer::Core::Camera &camera, CameraTypes &value) {
+                std::string name = std::get<std::string>(value);
+
+                if (name == "recursive") {
+                    camera.integrator(
+                        Raytracer::Core::Integrator::INTEGRATOR_RECURSIVE);
+                } else if (name == "iterative") {
+                    camera.integrator(
+                        Raytracer::Core::Integrator::INTEGRATOR_ITERATIVE);
+                } else {
+                    throw Exceptions::ArgumentException(
+                        std::format("unknown integrator `{}`", name));
+                }
+            },
+        },
+        {
+            "roulette_depth",
+            [](Raytracer::Core::Camera &camera, CameraTypes &value) {
+                camera.rouletteDepth(std::get<int>(value));
+            },
+        },
+        {
+            "adaptive_threshold",
+            [](Raytracer::Core::Camera &camera, CameraTypes &value) {
+                camera.adaptiveThreshold(std::get<double>(value));
+            },
+        },
+        {
+            "min_samples",
+            [](Raytracer::Core::Camera &camera, CameraTypes &value) {
+                camera.minSamples(std::max(1, std::get<int>(value)));
+            },
+        },
+        {
+            "sampler",
+            [](Raytracer::Core::Camera &camera, CameraTypes &value) {
+                std::string name = std::get<std::string>(value);
+
+                if (name == "uniform") {
+                    camera.sampler(
+                        std::make_shared<Raytracer::Samplers::Uniform>());
+                } else if (name == "sobol") {
+                    camera.sampler(
+                        std::make_shared<Raytracer::Samplers::Sobol>());
+                } else if (name == "blue_noise") {
+                    camera.sampler(
+                        std::make_shared<Raytracer::Samplers::BlueNoise>());
+                } else {
+                    throw Exceptions::ArgumentException(
+                        std::format("unknown sampler `{}`", name));
+                }
+            },
+        },
     };
 }
 
 /**
  * @brief Parse the configuration file
  *
- * Parse the configuration file and load the scene, textures, materials, shapes
- * and effects. If an error occurs while parsing the file, an exception is
- * thrown.
+ * Parse the configuration file and load the scene, textures, materials,
+ * shapes, effects and instances. If an error occurs while parsing the file,
+ * an exception is thrown.
  *
  * @param path Path to the configuration file
  * @throw Exceptions::ParseException if an error occurs while parsing the file
@@ -503,6 +618,8 @@ bool Raytracer::Config::Manager::parse(std::string path)
 {
     libconfig::Config config;
 
+    _files.push_back(path);
+
     try {
         config.readFile(path.c_str());
     } catch (const libconfig::FileIOException &e) {
@@ -530,6 +647,12 @@ bool Raytracer::Config::Manager::parse(std::string path)
         _ids.push_back(id);
         parseImports(scene["imports"]);
         parseCamera(scene["camera"]);
+        if (scene.exists("acceleration")) {
+            parseAcceleration(scene["acceleration"]);
+        }
+        if (scene.exists("animation")) {
+            parseAnimation(scene["animation"]);
+        }
         genericParse<Interfaces::ITexture, ConfigTextures>(
             scene["textures"], _textures);
         genericParse<Interfaces::IMaterial, ConfigMaterials>(
@@ -538,6 +661,10 @@ bool Raytracer::Config::Manager::parse(std::string path)
             scene["shapes"], _shapes);
         genericParse<Interfaces::IHittable, ConfigEffects>(
             scene["effects"], _effects);
+        if (scene.exists("instances")) {
+            genericParse<Interfaces::IHittable, ConfigShapes>(
+                scene["instances"], _shapes);
+        }
     } catch (const libconfig::SettingNotFoundException &e) {
         std::cerr << std::format(
             "path `{}` not found, aborting...", e.getPath())
@@ -597,14 +724,27 @@ void Raytracer::Config::Manager::genericParse(
         }
 
         std::string type = root["type"];
-        libconfig::Setting &args = root["args"];
-        std::shared_ptr<Interfaces::IArguments> argument = create(type, args);
+        std::string key = signature(setting.getName(), root);
+        std::shared_ptr<I> resource;
+
+        if (_resident && _resident->cache.contains(key)) {
+            resource = std::static_pointer_cast<I>(_resident->cache.at(key));
+            _reused++;
+        } else {
+            libconfig::Setting &args = root["args"];
+            std::shared_ptr<Interfaces::IArguments> argument =
+                create(type, args);
+
+            if (argument == nullptr) {
+                throw Exceptions::MissingException(
+                    "failed to create argument");
+            }
 
-        if (argument == nullptr) {
-            throw Exceptions::MissingException("failed to create argument");
+            resource = Factory::get<I, E>(type, argument);
         }
 
-        std::shared_ptr<I> resource = Factory::get<I, E>(type, argument);
+        _parsed++;
+        _cache[key] = resource;
 
         if (std::string(setting.getName()) == "effects") {
             std::shared_ptr<Raytracer::Interfaces::IHittable> instance =
@@ -616,14 +756,120 @@ void Raytracer::Config::Manager::genericParse(
                     "hittable is not an instance of IHittable");
             }
 
-            _shapes[root["args"]["target"]] = instance;
+            std::string target = root["args"]["target"];
+
+            _shapes[target] = instance;
+            _signatures["shapes:" + target] = key;
+            continue;
+        }
+
+        if (std::string(setting.getName()) == "instances") {
+            _prototypes.insert(root["args"]["target"]);
+            containerMap[id] = resource;
+            _signatures["shapes:" + id] = key;
             continue;
         }
 
         containerMap[id] = resource;
+        _signatures[std::string(setting.getName()) + ":" + id] = key;
     }
 }
 
+/**
+ * @brief Compute the signature of an object
+ *
+ * Compute a key that identifies the object described by the given setting:
+ * two settings with the same signature create the same object. The key is a
+ * hash of the setting, of the signatures of the objects it refers to by id
+ * and of the modification times of the files it refers to, so that the key
+ * of an object changes along with anything it is built from.
+ *
+ * @param kind Kind of the object, the name of its section
+ * @param root Setting of the object
+ *
+ * @return std::string Signature of the object
+ */
+std::string Raytracer::Config::Manager::signature(
+    const std::string &kind, const libconfig::Setting &root) const
+{
+    std::string text;
+
+    serialize(root, text);
+
+    return std::format(
+        "{}:{:016x}", kind, std::hash<std::string>()(text));
+}
+
+/**
+ * @brief Serialize a setting
+ *
+ * Append a textual form of the given setting and of its children to the given
+ * text. Strings naming a parsed object are followed by the signature of the
+ * object, and strings naming a file by its modification time.
+ *
+ * @param setting Setting to serialize
+ * @param text Text to append to
+ *
+ * @return void
+ */
+void Raytracer::Config::Manager::serialize(
+    const libconfig::Setting &setting, std::string &text) const
+{
+    if (setting.getName()) {
+        text += setting.getName();
+        text += '=';
+    }
+
+    switch (setting.getType()) {
+        case libconfig::Setting::TypeGroup:
+        case libconfig::Setting::TypeArray:
+        case libconfig::Setting::TypeList:
+            text += '(';
+            for (int i = 0; i < setting.getLength(); i++) {
+                serialize(setting[i], text);
+            }
+            text += ')';
+            break;
+        case libconfig::Setting::TypeInt:
+        case libconfig::Setting::TypeInt64:
+            text += std::to_string(static_cast<long long>(setting));
+            break;
+        case libconfig::Setting::TypeFloat:
+            text += std::to_string(
+                std::bit_cast<std::uint64_t>(static_cast<double>(setting)));
+            break;
+        case libconfig::Setting::TypeBoolean:
+            text += static_cast<bool>(setting) ? "true" : "false";
+            break;
+        case libconfig::Setting::TypeString: {
+            std::string value = setting;
+            std::error_code error;
+
+            text += '"' + value + '"';
+            for (const char *kind : {"textures", "materials", "shapes"}) {
+                auto it = _signatures.find(std::string(kind) + ":" + value);
+
+                if (it != _signatures.end()) {
+                    text += '@' + it->second;
+                }
+            }
+
+            std::filesystem::file_time_type time =
+                std::filesystem::last_write_time(value, error);
+
+            if (!error) {
+                text += '@'
+                    + std::to_string(time.time_since_epoch().count());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    text += ';';
+}
+
 /**
  * @brief Create an argument object
  *
@@ -723,6 +969,133 @@ void Raytracer::Config::Manager::parseImports(
     }
 }
 
+/**
+ * @brief Parse the acceleration structure settings
+ *
+ * Parse the optional acceleration settings from the configuration file. The
+ * `builder` selects how the BVH is split (`median` or `sah`), `layout`
+ * selects how it is stored (`tree`, `linear` or `bvh4`), `leaf_size` is the
+ * maximum number of objects in a leaf and `bins` is the number of bins
+ * evaluated per axis by the SAH builder.
+ *
+ * @param acceleration Acceleration settings to parse
+ * @throw Exceptions::ArgumentException if a setting is invalid
+ *
+ * @return void
+ */
+void Raytracer::Config::Manager::parseAcceleration(
+    const libconfig::Setting &acceleration)
+{
+    if (acceleration.exists("builder")) {
+        std::string builder = acceleration["builder"];
+
+        if (builder == "median") {
+            _acceleration.builder(Utils::BVHBuilder::BUILDER_MEDIAN);
+        } else if (builder == "sah") {
+            _acceleration.builder(Utils::BVHBuilder::BUILDER_SAH);
+        } else {
+            throw Exceptions::ArgumentException(
+                std::format("unknown BVH builder `{}`", builder));
+        }
+    }
+
+    if (acceleration.exists("layout")) {
+        std::string layout = acceleration["layout"];
+
+        if (layout == "tree") {
+            _acceleration.layout(Utils::BVHLayout::LAYOUT_TREE);
+        } else if (layout == "linear") {
+            _acceleration.layout(Utils::BVHLayout::LAYOUT_LINEAR);
+        } else if (layout == "bvh4") {
+            _acceleration.layout(Utils::BVHLayout::LAYOUT_BVH4);
+        } else {
+            throw Exceptions::ArgumentException(
+                std::format("unknown BVH layout `{}`", layout));
+        }
+    }
+
+    if (acceleration.exists("leaf_size")) {
+        int leafSize = acceleration["leaf_size"];
+
+        if (leafSize < 1) {
+            throw Exceptions::ArgumentException(
+                "leaf_size must be at least 1");
+        }
+        _acceleration.leafSize(leafSize);
+    }
+
+    if (acceleration.exists("bins")) {
+        int bins = acceleration["bins"];
+
+        if (bins < 2) {
+            throw Exceptions::ArgumentException("bins must be at least 2");
+        }
+        _acceleration.bins(bins);
+    }
+}
+
+/**
+ * @brief Parse the animation settings
+ *
+ * Parse the optional animation settings from the configuration file. The
+ * `keyframes` list sets the `look_from`, `look_at`, `v_fov` and
+ * `defocus_angle` of the camera at given frames, and the frames from `start`
+ * to `end` are rendered. `end` defaults to the last keyframe.
+ *
+ * @param animation Animation settings to parse
+ * @throw Exceptions::ArgumentException if a setting is invalid
+ *
+ * @return void
+ */
+void Raytracer::Config::Manager::parseAnimation(
+    const libconfig::Setting &animation)
+{
+    const libconfig::Setting &keyframes = animation["keyframes"];
+
+    for (int i = 0; i < keyframes.getLength(); i++) {
+        const libconfig::Setting &setting = keyframes[i];
+        Core::Keyframe keyframe;
+
+        keyframe.frame(setting["frame"]);
+        if (setting.exists("look_from")) {
+            keyframe.lookFrom(parseColor(setting["look_from"]));
+        }
+        if (setting.exists("look_at")) {
+            keyframe.lookAt(parseColor(setting["look_at"]));
+        }
+        if (setting.exists("v_fov")) {
+            keyframe.vFov(static_cast<double>(setting["v_fov"]));
+        }
+        if (setting.exists("defocus_angle")) {
+            keyframe.defocusAngle(
+                static_cast<double>(setting["defocus_angle"]));
+        }
+        _animation.add(keyframe);
+    }
+
+    if (_animation.empty()) {
+        throw Exceptions::ArgumentException(
+            "animation must have at least one keyframe");
+    }
+
+    int start = 0;
+    int end = _animation.keyframes().back().frame();
+
+    if (animation.exists("start")) {
+        start = animation["start"];
+    }
+    if (animation.exists("end")) {
+        end = animation["end"];
+    }
+
+    if (end < start) {
+        throw Exceptions::ArgumentException(
+            "animation end must not be before its start");
+    }
+    _animation.start(start);
+    _animation.end(end);
+}
+
 /**
  * @brief Extract the camera arguments
  *
@@ -736,8 +1109,8 @@ void Raytracer::Config::Manager::parseImports(
  * @return void
  */
 template <std::size_t I>
-void Raytracer::Config::Manager::extract(
-    const libconfig::Setting &setting, std::array<std::string, 10> &keys)
+void Raytracer::Config::Manager::extract(const libconfig::Setting &setting,
+    std::array<std::string, CameraKeys> &keys)
 {
     if constexpr (I != 0) {
         constexpr std::size_t F = I - 1;
@@ -766,7 +1139,7 @@ void Raytracer::Config::Manager::extract(
  */
 void Raytracer::Config::Manager::parseCamera(const libconfig::Setting &camera)
 {
-    std::array<std::string, 10> keys = {
+    std::array<std::string, CameraKeys> keys = {
         "aspect_ratio",
         "image_width",
         "samples_per_pixel",
@@ -777,10 +1150,15 @@ void Raytracer::Config::Manager::parseCamera(const libconfig::Setting &camera)
         "look_at",
         "v_up",
         "defocus_angle",
+        "integrator",
+        "roulette_depth",
+        "adaptive_threshold",
+        "min_samples",
+        "sampler",
     };
 
     try {
-        extract<10>(camera, keys);
+        extract<CameraKeys>(camera, keys);
     } catch (const std::bad_variant_access &e) {
         throw Exceptions::MissingException(
             "invalid variant access for camera argument");
@@ -835,18 +1213,384 @@ std::optional<T> Raytracer::Config::Manager::parseOptional(
     return Raytracer::Config::Manager::parseColor(setting[name]);
 }
 
+/**
+ * @brief Parse an optional argument
+ *
+ * Parse an optional argument from the configuration file and return it as an
+ * optional object.
+ *
+ * @tparam T Type of the argument
+ * @param setting Setting to parse
+ * @param name Name of the argument
+ *
+ * @return std::optional<T> Parsed optional argument
+ */
+template <typename T>
+    requires std::is_same_v<T, std::string>
+std::optional<T> Raytracer::Config::Manager::parseOptional(
+    const libconfig::Setting &setting, std::string &name)
+{
+    if (!setting.exists(name)) {
+        return std::nullopt;
+    }
+
+    std::string value = setting[name];
+
+    return value;
+}
+
 /**
  * @brief Bootstrap the configuration
  *
- * Bootstrap the configuration by adding the shapes to the world.
+ * Bootstrap the configuration by adding the shapes to the world. The shapes
+ * that are the target of an instance are only drawn through their instances.
+ * The camera is given the hash of the content of the configuration files, so
+ * that a checkpoint of another version of the scene is not resumed.
  *
  * @return void
  */
 void Raytracer::Config::Manager::bootstrap()
 {
     for (auto &[id, shape] : _shapes) {
-        _world.add(shape);
+        if (!_prototypes.contains(id)) {
+            _world.add(shape);
+        }
     }
+    _camera.sceneHash(contentHash());
+}
+
+/**
+ * @brief Compute the hash of the configuration files
+ *
+ * Compute a hash of the content of the configuration file and of every file
+ * it imports, in the order they were parsed. The paths are left out, so that
+ * the hash does not depend on the directory the files are loaded from.
+ *
+ * @return std::uint64_t Hash of the configuration files
+ */
+std::uint64_t Raytracer::Config::Manager::contentHash() const
+{
+    std::string text;
+
+    for (const std::string &path : _files) {
+        std::ifstream file(path, std::ios::binary);
+
+        text.append(std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>());
+        text += '\0';
+    }
+
+    return std::hash<std::string>()(text);
+}
+
+/**
+ * @brief Reuse the objects of a resident scene
+ *
+ * Keep the objects and the BVH of the given scene, typically a previous load
+ * of the same configuration file, so that the next parse reuses every object
+ * whose signature is unchanged instead of creating it again, and the next
+ * render refits the BVH of the resident scene instead of building a new one
+ * when only some of its objects were replaced.
+ *
+ * @param resident Scene to reuse the objects of
+ *
+ * @return void
+ */
+void Raytracer::Config::Manager::reuse(const Manager &resident)
+{
+    _resident = Resident{resident._cache, resident._shapes,
+        resident._prototypes, resident._tree, resident._treeCost,
+        resident._acceleration};
+}
+
+/**
+ * @brief Build the bounding volume hierarchy of the world
+ *
+ * Build the BVH of the bounded objects of the world with the builder selected
+ * in the acceleration settings, on as many threads as the camera renders
+ * with. Unbounded objects such as planes cannot be culled by a BVH and are
+ * added to the given scene instead. The SAH cost and build time are reported
+ * when statistics are enabled.
+ *
+ * @param unbounded Scene receiving the unbounded objects
+ *
+ * @return std::shared_ptr<Utils::BVHNode> Root of the BVH, or nullptr if the
+ * world has no bounded object
+ */
+std::shared_ptr<Raytracer::Utils::BVHNode> Raytracer::Config::Manager::build(
+    Core::Scene &unbounded)
+{
+    auto start = std::chrono::steady_clock::now();
+    Core::Scene bounded;
+
+    for (const auto &object : _world.objects()) {
+        if (std::isinf(object->boundingBox().surfaceArea())) {
+            unbounded.add(object);
+        } else {
+            bounded.add(object);
+        }
+    }
+
+    if (bounded.objects().empty()) {
+        return nullptr;
+    }
+
+    _acceleration.threads(_camera.threads());
+
+    std::shared_ptr<Utils::BVHNode> tree =
+        std::make_shared<Utils::BVHNode>(bounded, _acceleration);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    if (_camera.statistics()) {
+        std::clog << std::format(
+            "BVH: {} builder, SAH cost {:.3f}, built in {:.3f}s on {} "
+            "thread(s)",
+            _acceleration.builder() == Utils::BVHBuilder::BUILDER_SAH
+                ? "sah"
+                : "median",
+            tree->sahCost(), elapsed.count(), _acceleration.threads())
+                  << std::endl;
+    }
+
+    return tree;
+}
+
+/**
+ * @brief Refit the bounding volume hierarchy of the resident scene
+ *
+ * Refit the BVH of the resident scene to the objects of the world when the
+ * world holds the same bounded shapes, by id, as the resident scene and the
+ * BVH was built with the same settings. Shapes that are the target of an
+ * instance are not part of the world, so retargeting an instance changes the
+ * ids and forces a rebuild. The shapes that were created again since are
+ * swapped into a copy of the tree in place of the resident ones, leaving the
+ * tree of the resident scene untouched. The tree is rebuilt instead if the
+ * refit more than doubles its SAH cost. Unbounded objects are added to the
+ * given scene as when building the BVH.
+ *
+ * @param unbounded Scene receiving the unbounded objects
+ *
+ * @return std::shared_ptr<Utils::BVHNode> Root of the refitted BVH, or
+ * nullptr if the BVH must be built again
+ */
+std::shared_ptr<Raytracer::Utils::BVHNode> Raytracer::Config::Manager::refit(
+    Core::Scene &unbounded)
+{
+    if (!_resident || !_resident->tree
+        || _resident->acceleration.builder() != _acceleration.builder()
+        || _resident->acceleration.leafSize() != _acceleration.leafSize()
+        || _resident->acceleration.bins() != _acceleration.bins()) {
+        return nullptr;
+    }
+
+    auto bounded = [](const ManagerMap<Interfaces::IHittable> &shapes,
+                       const std::unordered_set<std::string> &prototypes) {
+        std::unordered_set<std::string> ids;
+
+        for (const auto &[id, shape] : shapes) {
+            if (!prototypes.contains(id)
+                && !std::isinf(shape->boundingBox().surfaceArea())) {
+                ids.insert(id);
+            }
+        }
+
+        return ids;
+    };
+    auto start = std::chrono::steady_clock::now();
+    std::unordered_set<std::string> ids = bounded(_shapes, _prototypes);
+
+    if (ids != bounded(_resident->shapes, _resident->prototypes)) {
+        return nullptr;
+    }
+
+    Utils::BVHNode::Replacements replacements;
+
+    for (const std::string &id : ids) {
+        const std::shared_ptr<Interfaces::IHittable> &shape = _shapes.at(id);
+        const std::shared_ptr<Interfaces::IHittable> &previous =
+            _resident->shapes.at(id);
+
+        if (previous != shape) {
+            replacements[previous.get()] = shape;
+        }
+    }
+
+    std::shared_ptr<Utils::BVHNode> tree =
+        _resident->tree->refit(replacements);
+
+    if (!tree) {
+        tree = _resident->tree;
+    }
+    if (tree->sahCost() > 2 * _resident->treeCost) {
+        return nullptr;
+    }
+
+    for (const auto &object : _world.objects()) {
+        if (std::isinf(object->boundingBox().surfaceArea())) {
+            unbounded.add(object);
+        }
+    }
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    if (_camera.statistics()) {
+        std::clog << std::format(
+            "BVH: refit to {} replaced object(s), SAH cost {:.3f}, in {:.3f}s",
+            replacements.size(), tree->sahCost(), elapsed.count())
+                  << std::endl;
+    }
+
+    return tree;
+}
+
+/**
+ * @brief Collect the lights of the world
+ *
+ * Collect the objects of the world that are lights the camera can sample
+ * directly, such as quads and spheres made of a diffuse light material.
+ *
+ * @return Core::Scene Scene holding the lights of the world
+ */
+Raytracer::Core::Scene Raytracer::Config::Manager::lights() const
+{
+    Core::Scene lights;
+
+    for (const auto &object : _world.objects()) {
+        if (object->emissive()) {
+            lights.add(object);
+        }
+    }
+
+    return lights;
+}
+
+/**
+ * @brief Store a bounding volume hierarchy in the given layout
+ *
+ * Wrap the given BVH in the traversal structure matching the layout: the
+ * tree itself, a flattened linear BVH or a 4-wide BVH.
+ *
+ * @param tree Root of the BVH
+ * @param layout Layout to store the BVH in
+ *
+ * @return std::shared_ptr<Interfaces::IHittable> Traversal structure
+ */
+std::shared_ptr<Raytracer::Interfaces::IHittable>
+Raytracer::Config::Manager::accelerate(
+    const std::shared_ptr<Utils::BVHNode> &tree, Utils::BVHLayout layout)
+{
+    switch (layout) {
+        case Utils::BVHLayout::LAYOUT_LINEAR:
+            return std::make_shared<Utils::LinearBVH>(*tree);
+        case Utils::BVHLayout::LAYOUT_BVH4:
+            return std::make_shared<Utils::BVH4>(*tree);
+        default:
+            return tree;
+    }
+}
+
+/**
+ * @brief Get the bottom-level structure of an instanced object
+ *
+ * Get the object drawn by the instances of the given object. An object made
+ * of several others, such as a box, gets a BVH of its own, built once with
+ * the acceleration settings and shared by all of its instances, so that the
+ * BVH of the world only holds the bounds of the instances. A transformed
+ * object keeps its transform over the structure of the object. Any other
+ * object is its own bottom-level structure.
+ *
+ * @param object Object to instance
+ *
+ * @return std::shared_ptr<Interfaces::IHittable> Bottom-level structure of
+ * the object
+ */
+std::shared_ptr<Raytracer::Interfaces::IHittable>
+Raytracer::Config::Manager::bottomLevel(
+    const std::shared_ptr<Interfaces::IHittable> &object)
+{
+    std::shared_ptr<Interfaces::IHittable> &structure =
+        _bottomLevels[object.get()];
+
+    if (structure) {
+        return structure;
+    }
+
+    std::shared_ptr<Effects::Transform> transform =
+        std::dynamic_pointer_cast<Effects::Transform>(object);
+    std::shared_ptr<Core::Scene> scene =
+        std::dynamic_pointer_cast<Core::Scene>(object);
+
+    if (transform) {
+        structure = std::make_shared<Effects::Transform>(
+            bottomLevel(transform->object()), transform->transform());
+    } else if (scene && scene->objects().size() > 1) {
+        structure = accelerate(
+            std::make_shared<Utils::BVHNode>(*scene, _acceleration),
+            _acceleration.layout());
+    } else {
+        structure = object;
+    }
+
+    return structure;
+}
+
+/**
+ * @brief Parse the transform of an instance
+ *
+ * Parse the optional `scale`, `rotate` and `translate` settings of an
+ * instance into the transform applying them in that order. `scale` is either
+ * a single factor or one factor per axis, and `rotate` holds the angles in
+ * degrees of the rotations around the x, y and z axes, applied in that
+ * order.
+ *
+ * @param args Arguments of the instance
+ * @throw Exceptions::ArgumentException if a scale factor is zero
+ *
+ * @return Utils::Affine Transform of the instance
+ */
+Raytracer::Utils::Affine Raytracer::Config::Manager::parseTransform(
+    const libconfig::Setting &args)
+{
+    Utils::Vec3 scale(1, 1, 1);
+    Utils::Affine transform;
+
+    if (args.exists("scale")) {
+        const libconfig::Setting &setting = args["scale"];
+
+        if (setting.getType() == libconfig::Setting::TypeArray
+            || setting.getType() == libconfig::Setting::TypeList) {
+            scale = parseColor(setting);
+        } else {
+            double factor = setting;
+
+            scale = Utils::Vec3(factor, factor, factor);
+        }
+    }
+
+    if (scale[0] == 0 || scale[1] == 0 || scale[2] == 0) {
+        throw Exceptions::ArgumentException(
+            "instance scale must not be zero");
+    }
+    transform = Utils::Affine::scaling(scale);
+
+    if (args.exists("rotate")) {
+        Utils::Vec3 angles = parseColor(args["rotate"]);
+
+        for (int axis = 0; axis < 3; axis++) {
+            transform =
+                Utils::Affine::rotation(axis, angles[axis]) * transform;
+        }
+    }
+
+    if (args.exists("translate")) {
+        transform =
+            Utils::Affine::translation(parseColor(args["translate"]))
+            * transform;
+    }
+
+    return transform;
 }
 
 /**
@@ -854,15 +1598,36 @@ void Raytracer::Config::Manager::bootstrap()
  *
  * Render the scene using the camera and the world. If the fast flag is set,
  * the rendering is done in fast mode, which reduces the image width, the
- * samples per pixel and the maximum depth.
+ * samples per pixel and the maximum depth. The world is traversed through
+ * the BVH layout selected in the acceleration settings, and its lights are
+ * handed to the camera to be sampled directly. The BVH is built on the first
+ * render and kept for the following ones, or refitted from the resident
+ * scene given to `reuse` when possible. If the scene is animated, every
+ * frame of the animation is rendered.
  *
  * @param fast Fast rendering mode
  *
- * @return void
+ * @return true if the scene was rendered and written, false otherwise
  */
-void Raytracer::Config::Manager::render(bool fast)
+bool Raytracer::Config::Manager::render(bool fast)
 {
-    Core::Scene bvh = Core::Scene(std::make_shared<Utils::BVHNode>(_world));
+    if (!_accelerated) {
+        Core::Scene bvh;
+        std::shared_ptr<Utils::BVHNode> tree = refit(bvh);
+
+        if (tree) {
+            _treeCost = _resident->treeCost;
+        } else {
+            tree = build(bvh);
+            _treeCost = tree ? tree->sahCost() : 0;
+        }
+        if (tree) {
+            bvh.add(accelerate(tree, _acceleration.layout()));
+        }
+        _tree = tree;
+        _accelerated = bvh;
+        _resident.reset();
+    }
 
     if (fast) {
         _camera.imageWidth(300);
@@ -870,5 +1635,139 @@ void Raytracer::Config::Manager::render(bool fast)
         _camera.maxDepth(50);
     }
 
-    _camera.render(bvh);
+    if (!_animation.empty()) {
+        return animate();
+    }
+
+    return _camera.render(*_accelerated, lights());
+}
+
+/**
+ * @brief Render the frames of the animation
+ *
+ * Render every frame of the animation with the scene and the BVH built once
+ * for all of them. The camera of each frame is set up from the keyframes and
+ * writes to the output, checkpoint, partial and sample map paths numbered
+ * with the frame. Two cameras take turns, so that a frame is written on
+ * another thread while the next one renders.
+ *
+ * @return true if every frame was rendered and written, false otherwise
+ */
+bool Raytracer::Config::Manager::animate()
+{
+    if (_camera.output().empty()) {
+        std::cerr << "ERROR: An animation must be rendered to a file"
+                  << std::endl;
+        return false;
+    }
+
+    Core::Scene lights = this->lights();
+    std::array<Core::Camera, 2> cameras = {_camera, _camera};
+    std::future<bool> writing;
+    bool rendered = true;
+    bool written = true;
+
+    for (int frame = _animation.start(); frame <= _animation.end(); frame++) {
+        Core::Camera &camera = cameras[frame % 2];
+
+        camera = _camera;
+        _animation.apply(camera, frame);
+        camera.output(Core::Animation::framePath(_camera.output(), frame));
+        if (!_camera.checkpoint().empty()) {
+            camera.checkpoint(
+                Core::Animation::framePath(_camera.checkpoint(), frame));
+        }
+        if (!_camera.partial().empty()) {
+            camera.partial(
+                Core::Animation::framePath(_camera.partial(), frame));
+        }
+        if (!_camera.sampleMap().empty()) {
+            camera.sampleMap(
+                Core::Animation::framePath(_camera.sampleMap(), frame));
+        }
+
+        std::clog << std::format("Frame {} ({} to {})", frame,
+            _animation.start(), _animation.end())
+                  << std::endl;
+        rendered = camera.trace(*_accelerated, lights);
+        if (writing.valid()) {
+            written = writing.get() && written;
+        }
+        if (!rendered) {
+            break;
+        }
+        writing = std::async(
+            std::launch::async, [&camera]() { return camera.write(); });
+        std::clog << std::endl;
+    }
+
+    if (writing.valid()) {
+        written = writing.get() && written;
+    }
+
+    return rendered && written;
+}
+
+/**
+ * @brief Benchmark the BVH layouts
+ *
+ * Render the scene on the calling thread once per BVH layout and print the
+ * number of rays traced, the rays per second and the number of BVH nodes
+ * visited per ray for each of them. Every layout traces the same samples,
+ * so the numbers are directly comparable.
+ *
+ * @param fast Fast rendering mode
+ *
+ * @return void
+ */
+void Raytracer::Config::Manager::benchmark(bool fast)
+{
+    if (fast) {
+        _camera.imageWidth(300);
+        _camera.samplesPerPixel(10);
+        _camera.maxDepth(50);
+    }
+
+    _camera.setup();
+
+    Core::Scene unbounded;
+    Core::Scene lights = this->lights();
+    std::shared_ptr<Utils::BVHNode> tree = build(unbounded);
+    std::vector<Core::Tile> tiles = _camera.tiles();
+    std::array<std::pair<std::string, Utils::BVHLayout>, 3> layouts = {{
+        {"tree", Utils::BVHLayout::LAYOUT_TREE},
+        {"linear", Utils::BVHLayout::LAYOUT_LINEAR},
+        {"bvh4", Utils::BVHLayout::LAYOUT_BVH4},
+    }};
+
+    std::cout << std::format("{:<8}{:>14}{:>14}{:>12}{:>12}", "layout",
+        "rays", "rays/s", "nodes/ray", "time")
+              << std::endl;
+
+    for (const auto &[name, layout] : layouts) {
+        Core::Scene world = unbounded;
+
+        if (tree) {
+            world.add(accelerate(tree, layout));
+        }
+
+        Utils::Counters::reset();
+        _camera.reset();
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (const Core::Tile &tile : tiles) {
+            _camera.renderTile(
+                world, lights, tile, _camera.samplesPerPixel());
+        }
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        double rays = static_cast<double>(Utils::Counters::rays);
+
+        std::cout << std::format("{:<8}{:>14}{:>14.0f}{:>12.2f}{:>11.3f}s",
+            name, Utils::Counters::rays, rays / elapsed.count(),
+            Utils::Counters::nodes / std::max(rays, 1.0), elapsed.count())
+                  << std::endl;
+    }
 }
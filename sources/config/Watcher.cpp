@@ -0,0 +1,125 @@
+#include "config/Watcher.hpp"
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <thread>
+
+/**
+ * @brief Construct a new Watcher object
+ *
+ * Create a watcher rendering the scene of the given config file again every
+ * time the file or one of its imports changes. The setup function applies
+ * the command line settings to every load of the scene.
+ *
+ * @param path Path of the config file
+ * @param setup Function applying the command line settings to a scene
+ * @param fast Fast rendering mode
+ */
+Raytracer::Config::Watcher::Watcher(
+    const std::string &path, const Setup &setup, bool fast)
+    : _path(path), _setup(setup), _fast(fast)
+{
+}
+
+/**
+ * @brief Render the scene whenever it changes
+ *
+ * Load and render the scene, then wait for its config files to change and
+ * render it again. A render is interrupted as soon as a file changes, so
+ * that the next one starts right away. A scene that fails to load is
+ * reported and the previous one is kept until the files change again.
+ *
+ * @return false if the scene could not be loaded the first time, the watcher
+ * runs forever otherwise
+ */
+bool Raytracer::Config::Watcher::run()
+{
+    if (!load()) {
+        return false;
+    }
+
+    bool loaded = true;
+
+    while (true) {
+        if (loaded) {
+            _manager->camera().interrupt([this]() { return changed(); });
+            if (!_manager->render(_fast)) {
+                std::cerr << "ERROR: Could not render '" << _path << "'"
+                          << std::endl;
+            }
+            std::clog << std::endl
+                      << "Watching " << _path << " for changes" << std::endl;
+        }
+
+        while (!changed()) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(pollInterval));
+        }
+
+        loaded = load();
+    }
+}
+
+/**
+ * @brief Load the scene
+ *
+ * Parse the config file into a new scene that reuses the unchanged objects
+ * and the BVH of the current one, and apply the command line settings to
+ * it. The modification times of the files of the scene are recorded first,
+ * so that a file changing during the load is picked up by the next one.
+ *
+ * @return true if the scene was loaded, false otherwise
+ */
+bool Raytracer::Config::Watcher::load()
+{
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<Manager> manager = std::make_unique<Manager>();
+
+    if (_manager) {
+        manager->reuse(*_manager);
+    }
+
+    bool parsed = manager->parse(_path);
+
+    _times.clear();
+    for (const std::string &file : manager->files()) {
+        std::error_code error;
+
+        _times[file] = std::filesystem::last_write_time(file, error);
+    }
+
+    if (!parsed) {
+        return false;
+    }
+
+    _setup(*manager);
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::clog << std::format("Loaded {} in {:.3f}s, {} of {} object(s) reused",
+        _path, elapsed.count(), manager->reused(), manager->parsed())
+              << std::endl;
+    _manager = std::move(manager);
+
+    return true;
+}
+
+/**
+ * @brief Check if the scene changed
+ *
+ * @return true if a config file of the scene was modified since it was
+ * loaded, false otherwise
+ */
+bool Raytracer::Config::Watcher::changed() const
+{
+    for (const auto &[file, time] : _times) {
+        std::error_code error;
+
+        if (std::filesystem::last_write_time(file, error) != time) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,158 @@
+#include "core/Animation.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <format>
+
+/**
+ * @brief Check if the animation has any keyframe.
+ *
+ * @return true if the animation has no keyframe, false otherwise.
+ */
+bool Raytracer::Core::Animation::empty() const
+{
+    return _keyframes.empty();
+}
+
+/**
+ * @brief Add a keyframe to the animation.
+ *
+ * This function inserts the given keyframe, keeping the keyframes sorted by
+ * frame.
+ *
+ * @param keyframe The keyframe to add.
+ * @return void
+ */
+void Raytracer::Core::Animation::add(const Keyframe &keyframe)
+{
+    auto it = std::upper_bound(_keyframes.begin(), _keyframes.end(), keyframe,
+        [](const Keyframe &a, const Keyframe &b) {
+            return a.frame() < b.frame();
+        });
+
+    _keyframes.insert(it, keyframe);
+}
+
+/**
+ * @brief Set the camera up for a frame of the animation.
+ *
+ * This function sets the position, target, field of view and defocus angle
+ * of the camera for the given frame. Each parameter is interpolated linearly
+ * between the keyframes around the frame that set it, and held before the
+ * first and after the last of them. A parameter that no keyframe sets keeps
+ * the value of the camera.
+ *
+ * @param camera The camera to set up.
+ * @param frame The frame to set the camera up for.
+ * @return void
+ */
+void Raytracer::Core::Animation::apply(Camera &camera, int frame) const
+{
+    std::optional<Utils::Point3> lookFrom = interpolate<Utils::Point3>(
+        frame, [](const Keyframe &key) { return key.lookFrom(); });
+    std::optional<Utils::Point3> lookAt = interpolate<Utils::Point3>(
+        frame, [](const Keyframe &key) { return key.lookAt(); });
+    std::optional<double> vFov = interpolate<double>(
+        frame, [](const Keyframe &key) { return key.vFov(); });
+    std::optional<double> defocusAngle = interpolate<double>(
+        frame, [](const Keyframe &key) { return key.defocusAngle(); });
+
+    if (lookFrom) {
+        camera.lookFrom(*lookFrom);
+    }
+    if (lookAt) {
+        camera.lookAt(*lookAt);
+    }
+    if (vFov) {
+        camera.vFov(*vFov);
+    }
+    if (defocusAngle) {
+        camera.defocusAngle(*defocusAngle);
+    }
+}
+
+/**
+ * @brief Get the path of a frame.
+ *
+ * This function replaces the last run of `#` characters of the given path
+ * with the frame number, padded with zeros to the length of the run. If the
+ * path has no `#`, the frame number is appended to the name of the file,
+ * before its extension.
+ *
+ * @param path The path pattern.
+ * @param frame The frame number.
+ * @return The path of the frame.
+ */
+std::string Raytracer::Core::Animation::framePath(
+    const std::string &path, int frame)
+{
+    std::size_t last = path.rfind('#');
+
+    if (last == std::string::npos) {
+        std::filesystem::path file(path);
+
+        return (file.parent_path()
+            / std::format("{}_{:04}{}", file.stem().string(), frame,
+                file.extension().string()))
+            .string();
+    }
+
+    std::size_t first = last;
+
+    while (first > 0 && path[first - 1] == '#') {
+        first--;
+    }
+
+    std::string number = std::to_string(frame);
+    std::size_t width = last - first + 1;
+
+    if (number.size() < width) {
+        number.insert(0, width - number.size(), '0');
+    }
+
+    return path.substr(0, first) + number + path.substr(last + 1);
+}
+
+/**
+ * @brief Interpolate a parameter of the keyframes.
+ *
+ * This function finds the last keyframe at or before the given frame and the
+ * first keyframe at or after it that set the parameter, and interpolates
+ * linearly between their values.
+ *
+ * @tparam T The type of the parameter.
+ * @tparam Getter The type of the function reading the parameter.
+ * @param frame The frame to interpolate the parameter at.
+ * @param get The function reading the parameter of a keyframe.
+ * @return The value of the parameter, or nothing if no keyframe sets it.
+ */
+template <typename T, typename Getter>
+std::optional<T> Raytracer::Core::Animation::interpolate(
+    int frame, Getter get) const
+{
+    const Keyframe *before = nullptr;
+    const Keyframe *after = nullptr;
+
+    for (const Keyframe &keyframe : _keyframes) {
+        if (!get(keyframe)) {
+            continue;
+        }
+        if (keyframe.frame() <= frame) {
+            before = &keyframe;
+        }
+        if (keyframe.frame() >= frame && !after) {
+            after = &keyframe;
+        }
+    }
+
+    if (!before && !after) {
+        return std::nullopt;
+    }
+    if (!before || !after || before->frame() == after->frame()) {
+        return *get(before ? *before : *after);
+    }
+
+    double t = static_cast<double>(frame - before->frame())
+        / (after->frame() - before->frame());
+
+    return (1 - t) * *get(*before) + t * *get(*after);
+}
@@ -1,6 +1,17 @@
 #include "core/Camera.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <typeinfo>
+#include "core/Coordinator.hpp"
 #include "interfaces/IHittable.hpp"
 #include "utils/Color.hpp"
+#include "utils/Counters.hpp"
+#include "utils/Sampler.hpp"
 #include "utils/VecN.hpp"
 
 /**
@@ -59,35 +70,949 @@ void Raytracer::Core::Camera::setup()
 /**
  * @brief Render the scene with the given camera.
  *
- * This function sets up the camera and prints the PPM header. It then loops
- * through each pixel in the image and calculates the pixel color based on the
- * number of samples per pixel. The pixel color is then written to the output
- * stream.
+ * This function sets up the camera and splits the image into tiles. The tiles
+ * are handed to a work-stealing scheduler, which renders them on a pool of
+ * worker threads into the floating-point accumulation buffer of the camera,
+ * which keeps the linear radiance summed over the samples of every pixel.
+ * Once all the tiles are done, the mean radiance of the pixels is written to
+ * the output, along with the map of the samples taken per pixel if one was
+ * requested.
+ *
+ * In progressive mode, the whole frame is rendered in successive passes of
+ * `passSamples` samples per pixel. The current image is written to the output
+ * every `previewInterval` seconds, and the render stops once every pixel is
+ * done, when the next pass would overrun the time budget or when the interrupt
+ * callback, if one is set, asks for the render to stop. Since a pixel takes
+ * the same samples whatever the passes, a progressive render that runs to
+ * completion produces the same image as a single pass.
+ *
+ * When a checkpoint path is set, the render is saved to it every
+ * `checkpointInterval` seconds and once it stops. When resuming, the pixels
+ * restored from the checkpoint carry on from the samples they already have.
+ * Since every sample is seeded from its pixel and index, the resumed render
+ * produces the same image as an uninterrupted one.
+ *
+ * Only the pixels of the configured region are rendered, with the samples of
+ * the configured sample range. When a partial path is set, the accumulation
+ * buffer of the region is written to it instead of the image, to be merged
+ * with the partial buffers of other renders of the same frame.
  *
  * @param world The world to render.
- * @return void
+ * @param lights The lights of the world to sample directly.
+ * @return true if the scene was rendered, false if the region or the sample
+ * range is empty, if the checkpoint could not be resumed or if the output
+ * could not be written.
+ */
+bool Raytracer::Core::Camera::render(
+    const Interfaces::IHittable &world, const Interfaces::IHittable &lights)
+{
+    return trace(world, lights) && write();
+}
+
+/**
+ * @brief Trace the scene into the accumulation buffer.
+ *
+ * This function runs every step of the render but the final write of the
+ * output, so that the buffers of the camera can be written while another
+ * camera renders the next frame of an animation.
+ *
+ * @param world The world to render.
+ * @param lights The lights of the world to sample directly.
+ * @return true if the scene was traced, false if the region or the sample
+ * range is empty or if the checkpoint could not be resumed.
  */
-void Raytracer::Core::Camera::render(const Interfaces::IHittable &world)
+bool Raytracer::Core::Camera::trace(
+    const Interfaces::IHittable &world, const Interfaces::IHittable &lights)
 {
     setup();
+    reset();
 
-    std::cout << "P3\n" << _imageWidth << ' ' << _imageHeight << "\n255\n";
+    if (window().width() <= 0 || window().height() <= 0
+        || sampleCount() <= 0) {
+        std::cerr << "ERROR: The region or the sample range to render is empty"
+                  << std::endl;
+        return false;
+    }
+
+    if (_resume && !readCheckpoint()) {
+        return false;
+    }
+
+    std::vector<Tile> work;
+    std::vector<Tile> finished;
+    Scheduler scheduler(_threads, _tileOrder, _tileSize);
+    Coordinator coordinator(_processes);
+    int count = _progressive ? std::max(1, _passSamples) : _samplesPerPixel;
+    std::uint64_t taken = 0;
+    std::mutex mutex;
+
+    for (const Tile &tile : tiles()) {
+        (complete(tile) ? finished : work).push_back(tile);
+    }
 
     auto start = std::chrono::steady_clock::now();
+    auto saved = start;
+    auto previewed = start;
+    auto checkpoint = [&](const std::vector<Tile> &tiles) {
+        auto now = std::chrono::steady_clock::now();
+
+        if (!_checkpoint.empty()
+            && std::chrono::duration<double>(now - saved).count()
+                >= _checkpointInterval) {
+            writeCheckpoint(tiles);
+            saved = now;
+        }
+    };
+
+    for (int pass = 1; !work.empty(); pass++) {
+        int total = static_cast<int>(work.size() + finished.size());
+        int done = static_cast<int>(finished.size());
+        auto begin = std::chrono::steady_clock::now();
+
+        auto finish = [&](const Tile &tile, std::uint64_t samples) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            taken += samples;
+            progress(start, pass, ++done, total, taken);
+            if (!_progressive) {
+                finished.push_back(tile);
+                checkpoint(finished);
+            }
+        };
+
+        if (_processes > 0) {
+            std::vector<Tile> sorted = work;
+
+            scheduler.sort(sorted);
+            if (!coordinator.run(
+                    sorted,
+                    [&](const Tile &tile) {
+                        renderTile(world, lights, tile, count);
+                        return packTile(tile);
+                    },
+                    [&](const Tile &tile, const std::vector<char> &result) {
+                        finish(tile, unpackTile(tile, result));
+                    })) {
+                std::cerr << std::endl
+                          << "ERROR: The worker processes failed to render "
+                             "the image"
+                          << std::endl;
+                return false;
+            }
+        } else {
+            scheduler.run(work, [&](const Tile &tile) {
+                finish(tile, renderTile(world, lights, tile, count));
+            });
+        }
+
+        std::erase_if(work, [this](const Tile &tile) {
+            return complete(tile);
+        });
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        double duration = std::chrono::duration<double>(now - begin).count();
+
+        if (work.empty() || !_progressive) {
+            break;
+        }
+        if (_timeBudget > 0 && elapsed + duration > _timeBudget) {
+            break;
+        }
+        if (_interrupt && _interrupt()) {
+            break;
+        }
+        if (!_output.empty()
+            && std::chrono::duration<double>(now - previewed).count()
+                >= _previewInterval) {
+            writeImage(image());
+            previewed = now;
+        }
+        checkpoint(tiles());
+    }
+
+    if (_statistics) {
+        double total =
+            std::accumulate(_samples.begin(), _samples.end(), 0.0);
+
+        std::clog << std::endl;
+        if (_processes > 0) {
+            coordinator.report(std::clog);
+        } else {
+            scheduler.report(std::clog);
+        }
+        std::clog << std::format("Samples: {:.1f} per pixel on average",
+            total / _samples.size())
+                  << std::endl;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write the output of the render.
+ *
+ * This function writes the last checkpoint of the render and the map of the
+ * samples taken per pixel if they were requested, then either the partial
+ * buffer of the region if a partial path is set, or the image. Every output
+ * is attempted even if a previous one could not be written.
+ *
+ * @return true if every output was written, false otherwise.
+ */
+bool Raytracer::Core::Camera::write() const
+{
+    bool written = true;
+
+    if (!_checkpoint.empty()) {
+        written = writeCheckpoint(tiles()) && written;
+    }
+    if (!_sampleMap.empty()) {
+        written = writeSampleMap(_samples) && written;
+    }
+
+    if (!_partial.empty()) {
+        written = writePartial() && written;
+    } else {
+        written = writeImage(image()) && written;
+    }
+
+    return written;
+}
+
+/**
+ * @brief Reset the accumulation buffer.
+ *
+ * This function sizes the accumulation buffer, the sample counts and the
+ * luminance statistics of the pixels to the image, with no sample taken.
+ *
+ * @return void
+ */
+void Raytracer::Core::Camera::reset()
+{
+    std::size_t pixels = static_cast<std::size_t>(_imageWidth) * _imageHeight;
+
+    _accumulator.assign(pixels, Utils::Color(0, 0, 0));
+    _samples.assign(pixels, 0);
+    _mean.assign(pixels, 0);
+    _squares.assign(pixels, 0);
+}
+
+/**
+ * @brief Get the window of the image to render.
+ *
+ * This function clips the configured region to the image bounds. An empty
+ * region stands for the whole image.
+ *
+ * @return The window of the image to render.
+ */
+Raytracer::Core::Tile Raytracer::Core::Camera::window() const
+{
+    if (_region.width() <= 0 || _region.height() <= 0) {
+        return Tile(0, 0, _imageWidth, _imageHeight);
+    }
+
+    int x0 = std::clamp(_region.x(), 0, _imageWidth);
+    int y0 = std::clamp(_region.y(), 0, _imageHeight);
+    int x1 = std::clamp(_region.x() + _region.width(), 0, _imageWidth);
+    int y1 = std::clamp(_region.y() + _region.height(), 0, _imageHeight);
+
+    return Tile(x0, y0, x1 - x0, y1 - y0);
+}
+
+/**
+ * @brief Split the image into tiles.
+ *
+ * This function splits the window of the image to render into square tiles
+ * of the configured tile size, in scanline order. The tiles on the right and
+ * bottom edges are clipped to the window bounds.
+ *
+ * @return The tiles covering the window.
+ */
+std::vector<Raytracer::Core::Tile> Raytracer::Core::Camera::tiles() const
+{
+    std::vector<Tile> result;
+    Tile bounds = window();
+    int size = std::max(1, _tileSize);
+    int right = bounds.x() + bounds.width();
+    int bottom = bounds.y() + bounds.height();
+
+    for (int y = bounds.y(); y < bottom; y += size) {
+        for (int x = bounds.x(); x < right; x += size) {
+            result.emplace_back(
+                x, y, std::min(size, right - x), std::min(size, bottom - y));
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Get the number of samples to take per pixel.
+ *
+ * This function returns the number of samples of the configured sample
+ * range, which defaults to all the samples per pixel. A pixel takes the
+ * samples of indices `samplesFrom` to `samplesTo`, so that renders of
+ * disjoint ranges can be merged into the full render.
+ *
+ * @return The number of samples to take per pixel.
+ */
+int Raytracer::Core::Camera::sampleCount() const
+{
+    int last = _samplesTo > 0 ? std::min(_samplesTo, _samplesPerPixel)
+                              : _samplesPerPixel;
+
+    return std::max(0, last - _samplesFrom);
+}
+
+/**
+ * @brief Render a single tile of the image.
+ *
+ * This function takes up to `count` more samples for every pixel of the given
+ * tile that is not done yet, carrying on from the samples it already has in
+ * the accumulation buffer.
+ * The random generator of the calling thread is reseeded from the camera
+ * seed, the pixel coordinates and the sample index before each sample, so
+ * the color of a pixel does not depend on which thread renders it or in which
+ * order the tiles are processed. The random numbers of each sample are drawn
+ * from the sampler of the camera, which decides how the samples of a pixel
+ * are distributed.
+ *
+ * When an adaptive threshold is set, the running mean and variance of the
+ * luminance of each pixel are tracked with Welford's algorithm, and sampling
+ * stops once the pixel has converged, after at least `minSamples` and at
+ * most `samplesPerPixel` samples. The linear radiance summed over the
+ * samples is kept in the accumulation buffer along with the number of
+ * samples taken, so that the mean can be recovered without any loss of
+ * range.
+ *
+ * @param world The world to render.
+ * @param lights The lights of the world to sample directly.
+ * @param tile The tile to render.
+ * @param count The maximum number of samples to take per pixel.
+ * @return The number of samples taken.
+ */
+std::uint64_t Raytracer::Core::Camera::renderTile(
+    const Interfaces::IHittable &world, const Interfaces::IHittable &lights,
+    const Tile &tile, int count)
+{
+    bool adaptive = _adaptiveThreshold > 0;
+    std::uint64_t taken = 0;
+
+    for (int j = tile.y(); j < tile.y() + tile.height(); j++) {
+        for (int i = tile.x(); i < tile.x() + tile.width(); i++) {
+            std::size_t index = static_cast<std::size_t>(j) * _imageWidth + i;
+            Utils::Color &pixelColor = _accumulator[index];
+            double &mean = _mean[index];
+            double &squares = _squares[index];
+            int &s = _samples[index];
+            int last = std::min(sampleCount(), s + count);
 
-    for (int j = 0; j < _imageHeight; j++) {
-        progress(start, j);
+            if (done(index)) {
+                continue;
+            }
 
-        for (int i = 0; i < _imageWidth; i++) {
-            Utils::Color pixelColor = Utils::Color(0, 0, 0);
+            while (s < last) {
+                int n = _samplesFrom + s;
 
-            for (int s = 0; s < _samplesPerPixel; s++) {
+                Utils::Random::local().seed(_seed, index, n);
+                Utils::Sampler::local().start(_sampler.get(), _seed, i, j, n);
                 Ray ray = getRay(i, j);
-                pixelColor += rayColor(ray, _maxDepth, world);
+                Utils::Color sample =
+                    _integrator == Integrator::INTEGRATOR_ITERATIVE
+                    ? pathColor(ray, world, lights)
+                    : rayColor(ray, _maxDepth, world);
+
+                pixelColor += sample;
+                s++;
+                taken++;
+
+                if (!adaptive) {
+                    continue;
+                }
+
+                double luminance = 0.2126 * sample.x() + 0.7152 * sample.y()
+                    + 0.0722 * sample.z();
+                double delta = luminance - mean;
+
+                mean += delta / s;
+                squares += delta * (luminance - mean);
+
+                if (done(index)) {
+                    break;
+                }
+            }
+        }
+    }
+    Utils::Sampler::local().start(nullptr, _seed, 0, 0, 0);
+
+    return taken;
+}
+
+/**
+ * @brief Pack the pixels of a tile.
+ *
+ * This function serialises the accumulated radiance, the luminance
+ * statistics and the sample count of every pixel of the given tile, so that
+ * a worker process can send them to the coordinator.
+ *
+ * @param tile The tile to pack.
+ * @return The packed pixels of the tile.
+ */
+std::vector<char> Raytracer::Core::Camera::packTile(const Tile &tile) const
+{
+    constexpr std::size_t stride = 5 * sizeof(double) + sizeof(int);
+    std::vector<char> result(stride * tile.width() * tile.height());
+    char *bytes = result.data();
+
+    for (int j = tile.y(); j < tile.y() + tile.height(); j++) {
+        for (int i = tile.x(); i < tile.x() + tile.width(); i++) {
+            std::size_t index = static_cast<std::size_t>(j) * _imageWidth + i;
+            double values[5] = {_accumulator[index].x(),
+                _accumulator[index].y(), _accumulator[index].z(),
+                _mean[index], _squares[index]};
+
+            std::memcpy(bytes, values, sizeof(values));
+            std::memcpy(bytes + sizeof(values), &_samples[index], sizeof(int));
+            bytes += stride;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Unpack the pixels of a tile.
+ *
+ * This function restores the pixels of the given tile from the result sent
+ * by a worker process.
+ *
+ * @param tile The tile to unpack.
+ * @param data The packed pixels of the tile.
+ * @return The number of samples taken by the worker.
+ */
+std::uint64_t Raytracer::Core::Camera::unpackTile(
+    const Tile &tile, const std::vector<char> &data)
+{
+    constexpr std::size_t stride = 5 * sizeof(double) + sizeof(int);
+    const char *bytes = data.data();
+    std::uint64_t taken = 0;
+
+    if (data.size() != stride * tile.width() * tile.height()) {
+        return 0;
+    }
+
+    for (int j = tile.y(); j < tile.y() + tile.height(); j++) {
+        for (int i = tile.x(); i < tile.x() + tile.width(); i++) {
+            std::size_t index = static_cast<std::size_t>(j) * _imageWidth + i;
+            double values[5];
+            int samples = 0;
+
+            std::memcpy(values, bytes, sizeof(values));
+            std::memcpy(&samples, bytes + sizeof(values), sizeof(int));
+            bytes += stride;
+
+            _accumulator[index] =
+                Utils::Color(values[0], values[1], values[2]);
+            _mean[index] = values[3];
+            _squares[index] = values[4];
+            taken += samples - _samples[index];
+            _samples[index] = samples;
+        }
+    }
+
+    return taken;
+}
+
+/**
+ * @brief Check if a pixel is done.
+ *
+ * This function checks if the given pixel has taken all of its samples, or
+ * has converged after at least `minSamples` samples when an adaptive
+ * threshold is set.
+ *
+ * @param index The index of the pixel.
+ * @return true if the pixel is done, false otherwise.
+ */
+bool Raytracer::Core::Camera::done(std::size_t index) const
+{
+    int s = _samples[index];
+
+    if (s >= sampleCount()) {
+        return true;
+    }
+
+    return _adaptiveThreshold > 0 && s >= _minSamples
+        && converged(_mean[index], std::sqrt(_squares[index] / (s - 1)), s);
+}
+
+/**
+ * @brief Check if a pixel has converged.
+ *
+ * This function estimates the error of the displayed value of a pixel from
+ * the mean and standard deviation of the luminance of its samples. The
+ * 95% confidence interval of the mean is mapped through the gamma curve of
+ * the output, so the threshold is expressed in displayed intensity, and the
+ * pixel has converged once the error falls under the adaptive threshold.
+ *
+ * @param mean The mean luminance of the samples.
+ * @param deviation The standard deviation of the luminance of the samples.
+ * @param count The number of samples.
+ * @return true if the pixel has converged, false otherwise.
+ */
+bool Raytracer::Core::Camera::converged(
+    double mean, double deviation, int count) const
+{
+    double error = 1.96 * deviation / std::sqrt(count);
+
+    return error / (2 * std::sqrt(std::max(mean, 1e-4)))
+        <= _adaptiveThreshold;
+}
+
+/**
+ * @brief Get the rendered image.
+ *
+ * This function resolves the accumulation buffer into the linear mean
+ * radiance of every pixel. Pixels without any sample are black.
+ *
+ * @return The colors of the pixels, row by row.
+ */
+std::vector<Raytracer::Utils::Color> Raytracer::Core::Camera::image() const
+{
+    std::vector<Utils::Color> result(_accumulator.size());
+
+    for (std::size_t i = 0; i < _accumulator.size(); i++) {
+        if (_samples[i] > 0) {
+            result[i] = (1.0 / _samples[i]) * _accumulator[i];
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Write a checkpoint of the render.
+ *
+ * This function saves the accumulated radiance, the luminance statistics and
+ * the sample counts of the pixels of the given tiles to the checkpoint path,
+ * every other pixel being saved as not rendered yet. The checkpoint starts
+ * with the settings that decide the samples of a pixel, which include the
+ * seed the random generator is reseeded from before each sample, so that it
+ * is only resumed by a render that would produce the same image. It is
+ * written to a temporary file first and then renamed over the previous
+ * checkpoint, so an interrupted write never loses the last checkpoint.
+ *
+ * @param finished The tiles that are not being rendered.
+ * @return true if the checkpoint was written, false otherwise.
+ */
+bool Raytracer::Core::Camera::writeCheckpoint(
+    const std::vector<Tile> &finished) const
+{
+    std::string temporary = _checkpoint + ".tmp";
+    std::ofstream file(temporary, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open checkpoint file '" << temporary
+                  << "'" << std::endl;
+        return false;
+    }
+
+    std::vector<double> values(5 * _accumulator.size(), 0);
+    std::vector<std::int32_t> counts(_samples.size(), 0);
+
+    for (const Tile &tile : finished) {
+        for (int j = tile.y(); j < tile.y() + tile.height(); j++) {
+            for (int i = tile.x(); i < tile.x() + tile.width(); i++) {
+                std::size_t index =
+                    static_cast<std::size_t>(j) * _imageWidth + i;
+
+                for (int c = 0; c < 3; c++) {
+                    values[5 * index + c] = _accumulator[index][c];
+                }
+                values[5 * index + 3] = _mean[index];
+                values[5 * index + 4] = _squares[index];
+                counts[index] = _samples[index];
             }
-            Utils::writeColor(std::cout, _pixelSampleScale * pixelColor);
         }
     }
+
+    std::string header = checkpointHeader();
+
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char *>(values.data()),
+        static_cast<std::streamsize>(values.size() * sizeof(double)));
+    file.write(reinterpret_cast<const char *>(counts.data()),
+        static_cast<std::streamsize>(counts.size() * sizeof(std::int32_t)));
+    file.close();
+
+    std::error_code error;
+
+    if (file) {
+        std::filesystem::rename(temporary, _checkpoint, error);
+    }
+    if (!file || error) {
+        std::cerr << "ERROR: Could not write checkpoint file '" << _checkpoint
+                  << "'" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read the checkpoint of the render.
+ *
+ * This function restores the accumulated radiance, the luminance statistics
+ * and the sample counts of the pixels from the checkpoint path. The
+ * checkpoint is rejected if it was written for another scene or with
+ * settings that would produce a different image.
+ *
+ * @return true if the checkpoint was restored, false otherwise.
+ */
+bool Raytracer::Core::Camera::readCheckpoint()
+{
+    std::ifstream file(_checkpoint, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open checkpoint file '" << _checkpoint
+                  << "'" << std::endl;
+        return false;
+    }
+
+    std::string expected = checkpointHeader();
+    std::string header(expected.size(), '\0');
+    std::vector<double> values(5 * _accumulator.size());
+    std::vector<std::int32_t> counts(_samples.size());
+
+    file.read(header.data(), static_cast<std::streamsize>(header.size()));
+    if (!file || header != expected) {
+        std::cerr << "ERROR: Checkpoint file '" << _checkpoint
+                  << "' does not match the scene or the render settings"
+                  << std::endl;
+        return false;
+    }
+
+    file.read(reinterpret_cast<char *>(values.data()),
+        static_cast<std::streamsize>(values.size() * sizeof(double)));
+    file.read(reinterpret_cast<char *>(counts.data()),
+        static_cast<std::streamsize>(counts.size() * sizeof(std::int32_t)));
+    if (!file) {
+        std::cerr << "ERROR: Checkpoint file '" << _checkpoint
+                  << "' is truncated" << std::endl;
+        return false;
+    }
+
+    for (std::size_t index = 0; index < _accumulator.size(); index++) {
+        _accumulator[index] = Utils::Color(values[5 * index],
+            values[5 * index + 1], values[5 * index + 2]);
+        _mean[index] = values[5 * index + 3];
+        _squares[index] = values[5 * index + 4];
+        _samples[index] = counts[index];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the header of the checkpoints of the render.
+ *
+ * This function serialises the settings that decide the samples of a pixel,
+ * including the view of the camera and the hash of the scene it renders,
+ * into the header that identifies the checkpoints of the render.
+ *
+ * @return The header of the checkpoints.
+ */
+std::string Raytracer::Core::Camera::checkpointHeader() const
+{
+    const Interfaces::ISampler &sampler = *_sampler;
+    Tile bounds = window();
+
+    std::string header = std::format(
+        "RTCHECKPOINT 5\n{:016x}\n{} {} {} {} {} {} {} {} {}\n"
+        "{} {} {} {} {} {}\n{}\n",
+        _sceneHash, _imageWidth, _imageHeight, _samplesPerPixel, _maxDepth,
+        _seed, static_cast<int>(_integrator), _rouletteDepth,
+        _adaptiveThreshold, _minSamples, bounds.x(), bounds.y(),
+        bounds.width(), bounds.height(), _samplesFrom, sampleCount(),
+        typeid(sampler).name());
+
+    for (const Utils::Vec3 &vector : {_lookFrom, _lookAt, _vUp}) {
+        header += std::format(
+            "{} {} {} ", vector.x(), vector.y(), vector.z());
+    }
+
+    return header
+        + std::format("{} {} {}\n", _vFov, _defocusAngle, _focusDistance);
+}
+
+/**
+ * @brief Write the partial buffer of the render.
+ *
+ * This function writes the accumulated radiance and the sample counts of the
+ * pixels of the rendered window to the partial path. The header holds the
+ * size of the image and the window, so that the partial buffers of several
+ * renders can be merged into the full image.
+ *
+ * @return true if the partial buffer was written, false otherwise.
+ */
+bool Raytracer::Core::Camera::writePartial() const
+{
+    std::ofstream file(_partial, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open partial file '" << _partial << "'"
+                  << std::endl;
+        return false;
+    }
+
+    Tile bounds = window();
+    std::string header = std::format("RTPARTIAL 1\n{} {}\n{} {} {} {}\n",
+        _imageWidth, _imageHeight, bounds.x(), bounds.y(), bounds.width(),
+        bounds.height());
+    std::vector<double> radiance;
+    std::vector<std::int32_t> counts;
+
+    radiance.reserve(3 * bounds.width() * bounds.height());
+    counts.reserve(bounds.width() * bounds.height());
+    for (int j = bounds.y(); j < bounds.y() + bounds.height(); j++) {
+        for (int i = bounds.x(); i < bounds.x() + bounds.width(); i++) {
+            std::size_t index = static_cast<std::size_t>(j) * _imageWidth + i;
+
+            for (int c = 0; c < 3; c++) {
+                radiance.push_back(_accumulator[index][c]);
+            }
+            counts.push_back(_samples[index]);
+        }
+    }
+
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char *>(radiance.data()),
+        static_cast<std::streamsize>(radiance.size() * sizeof(double)));
+    file.write(reinterpret_cast<const char *>(counts.data()),
+        static_cast<std::streamsize>(counts.size() * sizeof(std::int32_t)));
+    file.close();
+    if (!file) {
+        std::cerr << "ERROR: Could not write partial file '" << _partial
+                  << "'" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Add a partial buffer to the accumulation buffer.
+ *
+ * This function reads the partial buffer at the given path and adds its
+ * radiance and sample counts to the pixels of its window. The first partial
+ * buffer read sizes the image, the following ones must have the same size.
+ *
+ * @param path The path of the partial buffer.
+ * @return true if the partial buffer was added, false otherwise.
+ */
+bool Raytracer::Core::Camera::readPartial(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open partial file '" << path << "'"
+                  << std::endl;
+        return false;
+    }
+
+    std::string magic;
+    int version = 0;
+    int width = 0;
+    int height = 0;
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+
+    file >> magic >> version >> width >> height >> x >> y >> w >> h;
+    file.get();
+    if (!file || magic != "RTPARTIAL" || version != 1 || width <= 0
+        || height <= 0 || x < 0 || y < 0 || w < 0 || h < 0 || x + w > width
+        || y + h > height) {
+        std::cerr << "ERROR: Invalid partial file '" << path << "'"
+                  << std::endl;
+        return false;
+    }
+
+    if (_accumulator.empty()) {
+        _imageWidth = width;
+        _imageHeight = height;
+        reset();
+    } else if (width != _imageWidth || height != _imageHeight) {
+        std::cerr << "ERROR: Partial file '" << path
+                  << "' does not match the size of the image" << std::endl;
+        return false;
+    }
+
+    std::vector<double> radiance(3 * static_cast<std::size_t>(w) * h);
+    std::vector<std::int32_t> counts(static_cast<std::size_t>(w) * h);
+
+    file.read(reinterpret_cast<char *>(radiance.data()),
+        static_cast<std::streamsize>(radiance.size() * sizeof(double)));
+    file.read(reinterpret_cast<char *>(counts.data()),
+        static_cast<std::streamsize>(counts.size() * sizeof(std::int32_t)));
+    if (!file) {
+        std::cerr << "ERROR: Partial file '" << path << "' is truncated"
+                  << std::endl;
+        return false;
+    }
+
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            std::size_t source = static_cast<std::size_t>(j) * w + i;
+            std::size_t index =
+                static_cast<std::size_t>(y + j) * _imageWidth + x + i;
+
+            _accumulator[index] += Utils::Color(radiance[3 * source],
+                radiance[3 * source + 1], radiance[3 * source + 2]);
+            _samples[index] += counts[source];
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Merge partial buffers into the final image.
+ *
+ * This function adds up the partial buffers at the given paths and writes
+ * the resulting image to the output. Since the radiance and the sample
+ * counts of every pixel are summed, partial buffers of disjoint windows are
+ * stitched together and partial buffers of disjoint sample ranges are
+ * averaged, weighted by their number of samples.
+ *
+ * @param paths The paths of the partial buffers.
+ * @return true if the image was merged, false otherwise.
+ */
+bool Raytracer::Core::Camera::merge(const std::vector<std::string> &paths)
+{
+    _accumulator.clear();
+    for (const std::string &path : paths) {
+        if (!readPartial(path)) {
+            return false;
+        }
+    }
+
+    return writeImage(image());
+}
+
+/**
+ * @brief Check if a tile has been rendered.
+ *
+ * This function checks if every pixel of the given tile is done, so that the
+ * tile needs no more samples.
+ *
+ * @param tile The tile to check.
+ * @return true if the tile has been rendered, false otherwise.
+ */
+bool Raytracer::Core::Camera::complete(const Tile &tile) const
+{
+    for (int j = tile.y(); j < tile.y() + tile.height(); j++) {
+        for (int i = tile.x(); i < tile.x() + tile.width(); i++) {
+            if (!done(static_cast<std::size_t>(j) * _imageWidth + i)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write the map of the samples taken per pixel.
+ *
+ * This function writes the number of samples taken for every pixel as a
+ * grayscale binary PPM image to the sample map path, white being the
+ * maximum number of samples per pixel.
+ *
+ * @param samples The number of samples taken for each pixel.
+ * @return true if the sample map was written, false otherwise.
+ */
+bool Raytracer::Core::Camera::writeSampleMap(
+    const std::vector<int> &samples) const
+{
+    std::ofstream file(_sampleMap, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open sample map file '" << _sampleMap
+                  << "'" << std::endl;
+        return false;
+    }
+
+    std::string header = "P6\n" + std::to_string(_imageWidth) + ' '
+        + std::to_string(_imageHeight) + "\n255\n";
+    std::string buffer = header;
+
+    buffer.reserve(header.size() + 3 * samples.size());
+    for (int count : samples) {
+        buffer.append(3,
+            static_cast<char>(255 * count / std::max(1, sampleCount())));
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.close();
+    if (!file) {
+        std::cerr << "ERROR: Could not write sample map file '" << _sampleMap
+                  << "'" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write the rendered image.
+ *
+ * This function writes the framebuffer to the output path, or to the
+ * standard output if no output path is set. The format is picked from the
+ * extension of the output path: `.pfm` and `.exr` keep the linear radiance
+ * as floats, anything else is quantised to a binary PPM image. The image is
+ * written in one go.
+ *
+ * @param framebuffer The colors of the pixels, row by row.
+ * @return true if the image was written, false otherwise.
+ */
+bool Raytracer::Core::Camera::writeImage(
+    const std::vector<Utils::Color> &framebuffer) const
+{
+    if (_output.empty()) {
+        Utils::writePPM(std::cout, _imageWidth, _imageHeight, framebuffer);
+        std::cout << std::flush;
+        if (!std::cout) {
+            std::cerr << "ERROR: Could not write the image to the standard "
+                         "output"
+                      << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::ofstream file(_output, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open output file '" << _output << "'"
+                  << std::endl;
+        return false;
+    }
+
+    if (_output.ends_with(".pfm")) {
+        Utils::writePFM(file, _imageWidth, _imageHeight, framebuffer);
+    } else if (_output.ends_with(".exr")) {
+        Utils::writeEXR(file, _imageWidth, _imageHeight, framebuffer);
+    } else {
+        Utils::writePPM(file, _imageWidth, _imageHeight, framebuffer);
+    }
+    file.close();
+    if (!file) {
+        std::cerr << "ERROR: Could not write output file '" << _output << "'"
+                  << std::endl;
+        return false;
+    }
+
+    return true;
 }
 
 /**
@@ -98,6 +1023,8 @@ void Raytracer::Core::Camera::render(const Interfaces::IHittable &world)
  * camera if the defocus angle is less than or equal to 0. Otherwise, the
  * origin is set to a point on the defocus disk. The direction is set to the
  * sample location minus the origin. The time is set to a random double.
+ * The pixel offset, the lens position and the time use the first
+ * `cameraDimensions` dimensions of the sample.
  *
  * @param i The x coordinate of the pixel.
  * @param j The y coordinate of the pixel.
@@ -105,13 +1032,19 @@ void Raytracer::Core::Camera::render(const Interfaces::IHittable &world)
  */
 Raytracer::Core::Ray Raytracer::Core::Camera::getRay(double i, double j) const
 {
+    Utils::Sampler &sampler = Utils::Sampler::local();
+
+    sampler.dimensions(0, 2);
     Utils::Vec3 offset = sampleSquare();
     Utils::Vec3 sample = _pixelZeroLoc + ((i + offset.x()) * _pixelDeltaU)
         + ((j + offset.y()) * _pixelDeltaV);
 
+    sampler.dimensions(2, 2);
     Utils::Point3 origin =
         (_defocusAngle <= 0) ? _center : sampleDefocusDisk();
     Utils::Vec3 direction = sample - origin;
+
+    sampler.dimensions(4, 1);
     double time = Utils::randomDouble();
 
     return Ray(origin, direction, time);
@@ -182,7 +1115,13 @@ Raytracer::Utils::Color Raytracer::Core::Camera::rayColor(
 
     Payload payload;
     double infinity = std::numeric_limits<double>::infinity();
+    Utils::Sampler &sampler = Utils::Sampler::local();
+    std::uint32_t base =
+        cameraDimensions + (_maxDepth - depth) * bounceDimensions;
+
+    Utils::Counters::rays++;
 
+    sampler.dimensions(base + 6, 2);
     if (!world.hit(ray, Utils::Interval(0.001, infinity), payload)) {
         return _backgroundColor;
     }
@@ -192,6 +1131,7 @@ Raytracer::Utils::Color Raytracer::Core::Camera::rayColor(
     Utils::Color emissionColor =
         payload.material()->emitted(payload.u(), payload.v(), payload.point());
 
+    sampler.dimensions(base, 2);
     if (!payload.material()->scatter(ray, payload, attenuation, scattered)) {
         return emissionColor;
     }
@@ -202,32 +1142,224 @@ Raytracer::Utils::Color Raytracer::Core::Camera::rayColor(
     return emissionColor + scatterColor;
 }
 
+/**
+ * @brief Get the color of the ray with an iterative path tracer.
+ *
+ * This function follows the path of the ray bounce after bounce, carrying
+ * the product of the attenuations as the throughput, up to the maximum
+ * depth. After `rouletteDepth` bounces, the path is terminated with a
+ * probability based on its throughput and surviving paths are weighted by
+ * the inverse of their survival probability, which keeps the estimate
+ * unbiased while not tracing paths that barely contribute.
+ *
+ * At every diffuse bounce the lights are also sampled directly with a shadow
+ * ray. Light reaching a diffuse surface is thus estimated twice, once by the
+ * shadow ray and once by the scattered ray hitting the light, and the two
+ * estimates are combined with multiple importance sampling: each one is
+ * weighted with the power heuristic of the densities of both strategies.
+ * Emission reached from the camera or after a specular bounce cannot be
+ * sampled through the lights and is always counted in full.
+ *
+ * Every bounce draws from its own `bounceDimensions` dimensions of the
+ * sample: two for scattering, three for the light sample, one for Russian
+ * roulette and two for participating media.
+ *
+ * @param ray The ray to get the color of.
+ * @param world The world to get the color from.
+ * @param lights The lights of the world to sample directly.
+ * @return The color of the ray.
+ */
+Raytracer::Utils::Color Raytracer::Core::Camera::pathColor(Ray ray,
+    const Interfaces::IHittable &world,
+    const Interfaces::IHittable &lights) const
+{
+    Utils::Color color(0, 0, 0);
+    Utils::Color throughput(1, 1, 1);
+    double infinity = std::numeric_limits<double>::infinity();
+    bool sampleLights = lights.emissive();
+    double scatterPdf = 0;
+    Utils::Sampler &sampler = Utils::Sampler::local();
+
+    for (int depth = 0; depth < _maxDepth; depth++) {
+        Payload payload;
+        std::uint32_t base = cameraDimensions + depth * bounceDimensions;
+
+        Utils::Counters::rays++;
+
+        sampler.dimensions(base + 6, 2);
+        if (!world.hit(ray, Utils::Interval(0.001, infinity), payload)) {
+            color += throughput * _backgroundColor;
+            break;
+        }
+
+        Ray scattered;
+        Utils::Color attenuation;
+        Utils::Color emission = payload.material()->emitted(
+            payload.u(), payload.v(), payload.point());
+
+        if (scatterPdf > 0 && payload.material()->emits()) {
+            emission *= powerHeuristic(
+                scatterPdf, lightPdf(ray, payload.t(), lights));
+        }
+        color += throughput * emission;
+
+        sampler.dimensions(base, 2);
+        if (!payload.material()->scatter(
+                ray, payload, attenuation, scattered)) {
+            break;
+        }
+
+        scatterPdf = sampleLights
+            ? payload.material()->scatteringPdf(ray, payload, scattered)
+            : 0;
+
+        if (scatterPdf > 0) {
+            sampler.dimensions(base + 2, 3);
+            color += throughput * attenuation
+                * directLight(ray, payload, world, lights);
+        }
+
+        throughput = throughput * attenuation;
+        ray = scattered;
+
+        if (depth + 1 >= _rouletteDepth) {
+            double survival = std::min(0.95,
+                std::max({throughput.x(), throughput.y(), throughput.z()}));
+
+            sampler.dimensions(base + 5, 1);
+            if (Utils::randomDouble() >= survival) {
+                break;
+            }
+            throughput /= survival;
+        }
+    }
+
+    return color;
+}
+
+/**
+ * @brief Sample the light reaching a surface directly.
+ *
+ * This function traces a shadow ray from the hit point towards a random
+ * point of the lights. If the shadow ray reaches the sampled lights, their
+ * emission is returned, scaled by the scattering density of the material
+ * and weighted against scattering with the power heuristic. The result
+ * still has to be multiplied by the attenuation of the material.
+ *
+ * @param ray The ray that hit the surface.
+ * @param payload The hit information of the surface.
+ * @param world The world to trace the shadow ray in.
+ * @param lights The lights of the world to sample.
+ * @return The light reaching the surface from the lights.
+ */
+Raytracer::Utils::Color Raytracer::Core::Camera::directLight(const Ray &ray,
+    const Payload &payload, const Interfaces::IHittable &world,
+    const Interfaces::IHittable &lights) const
+{
+    Ray shadow(payload.point(), lights.random(payload.point()), ray.time());
+    double scatterPdf =
+        payload.material()->scatteringPdf(ray, payload, shadow);
+
+    if (scatterPdf <= 0) {
+        return Utils::Color(0, 0, 0);
+    }
+
+    Payload light;
+    double infinity = std::numeric_limits<double>::infinity();
+
+    Utils::Counters::rays++;
+
+    if (!world.hit(shadow, Utils::Interval(0.001, infinity), light)
+        || !light.material()->emits()) {
+        return Utils::Color(0, 0, 0);
+    }
+
+    double pdf = lightPdf(shadow, light.t(), lights);
+
+    if (pdf <= 0) {
+        return Utils::Color(0, 0, 0);
+    }
+
+    return light.material()->emitted(light.u(), light.v(), light.point())
+        * (scatterPdf * powerHeuristic(pdf, scatterPdf) / pdf);
+}
+
+/**
+ * @brief Get the density of sampling a ray through the lights.
+ *
+ * This function returns the probability density of the lights generating
+ * the direction of the given ray, if the first light along the ray is the
+ * surface hit at distance `t`. Emitters that are not part of the lights,
+ * because they cannot be sampled, have a density of 0.
+ *
+ * @param ray The ray to get the density of.
+ * @param t The distance of the emitter hit by the ray.
+ * @param lights The lights of the world.
+ * @return The probability density of the direction of the ray.
+ */
+double Raytracer::Core::Camera::lightPdf(
+    const Ray &ray, double t, const Interfaces::IHittable &lights) const
+{
+    Payload payload;
+    double infinity = std::numeric_limits<double>::infinity();
+
+    if (!lights.hit(ray, Utils::Interval(0.001, infinity), payload)
+        || std::fabs(payload.t() - t) > 1e-9 * std::max(1.0, t)) {
+        return 0;
+    }
+
+    return lights.pdfValue(ray.origin(), ray.direction());
+}
+
+/**
+ * @brief Weight of a sampling strategy with the power heuristic.
+ *
+ * This function returns the multiple importance sampling weight of a sample
+ * drawn with density `pdf` when another strategy could have produced it
+ * with density `other`.
+ *
+ * @param pdf The density of the strategy that drew the sample.
+ * @param other The density of the other strategy.
+ * @return The weight of the sample.
+ */
+double Raytracer::Core::Camera::powerHeuristic(double pdf, double other)
+{
+    return (pdf * pdf) / (pdf * pdf + other * other);
+}
+
 /**
  * @brief Print the progress of the rendering.
  *
- * This function prints the progress of the rendering to the standard error
- * stream. The progress is printed as a percentage and the time elapsed is
- * printed in seconds.
+ * This function prints the progress of the current pass to the standard
+ * error stream. The progress is printed as a percentage of the tiles of the
+ * pass that have been rendered, followed by the number of samples taken per
+ * second since the start of the rendering and the time elapsed in seconds.
  *
  * @param start The start time of the rendering.
- * @param j The y coordinate of the pixel.
+ * @param pass The number of the current pass.
+ * @param done The number of tiles of the pass rendered so far.
+ * @param total The total number of tiles of the pass.
+ * @param samples The number of samples taken since the start.
  * @return void
  */
 void Raytracer::Core::Camera::progress(
-    const std::chrono::steady_clock::time_point &start, int j) const
+    const std::chrono::steady_clock::time_point &start, int pass, int done,
+    int total, std::uint64_t samples) const
 {
-    std::clog << "\rProgress: [";
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    double rate = elapsed.count() > 0 ? samples / elapsed.count() : 0;
+
+    std::clog << "\rPass " << pass << ": [";
     std::clog << "\033[36m";
     for (int p = 0; p < 50; ++p) {
-        if (p * 100 / 50 <= j * 100 / _imageHeight)
+        if (p * 100 / 50 <= done * 100 / total)
             std::clog << "#";
         else
             std::clog << " ";
     }
     std::clog << "\033[0m";
-    std::clog << "] " << j * 100 / _imageHeight << "%" << " ("
-              << std::chrono::duration_cast<std::chrono::seconds>(
-                     std::chrono::steady_clock::now() - start)
-                     .count()
-              << "s)" << std::flush;
+    std::clog << "] " << done * 100 / total << "%"
+              << std::format(" {:.2f}M samples/s", rate / 1e6) << " ("
+              << static_cast<int>(elapsed.count()) << "s)" << std::flush;
 }
@@ -0,0 +1,354 @@
+#include "core/Coordinator.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <iostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @brief Construct a new Coordinator object.
+ *
+ * This function constructs a new Coordinator object that farms tiles out to
+ * the given number of worker processes.
+ *
+ * @param processes The number of worker processes.
+ *
+ * @return A new Coordinator object.
+ */
+Raytracer::Core::Coordinator::Coordinator(int processes)
+    : _processes(std::max(1, processes))
+{
+}
+
+/**
+ * @brief Run the given task on every tile in worker processes.
+ *
+ * This function forks the worker processes, which inherit the scene and its
+ * BVH from the coordinator and keep them resident. The tiles are handed out
+ * one at a time, in the given order, to whichever worker is idle. Each worker
+ * runs the task on its tile and sends the result back over a Unix socket,
+ * where it is passed to `gather` in the coordinator, before getting the next
+ * tile. The tile of a worker that dies is handed to another worker. The
+ * workers exit once every tile is done.
+ *
+ * @param tiles The tiles to process.
+ * @param task The task run by the workers, returning the result of a tile.
+ * @param gather The function given the result of every tile.
+ * @return true if every tile was processed, false otherwise.
+ */
+bool Raytracer::Core::Coordinator::run(
+    const std::vector<Tile> &tiles, const Task &task, const Gather &gather)
+{
+    std::deque<Tile> queue(tiles.begin(), tiles.end());
+    std::vector<char> result;
+
+    if (!spawn(task)) {
+        stop();
+        return false;
+    }
+
+    while (true) {
+        std::vector<pollfd> fds;
+        std::vector<Worker *> owners;
+
+        for (Worker &worker : _workers) {
+            if (worker.socket >= 0 && !worker.busy && !queue.empty()
+                && dispatch(worker, queue.front())) {
+                queue.pop_front();
+            }
+            if (worker.busy) {
+                fds.push_back({worker.socket, POLLIN, 0});
+                owners.push_back(&worker);
+            }
+        }
+
+        if (fds.empty()) {
+            break;
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (std::size_t i = 0; i < fds.size(); i++) {
+            Worker &worker = *owners[i];
+
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            if (collect(worker, result)) {
+                gather(worker.tile, result);
+            } else {
+                queue.push_front(worker.tile);
+                _lost++;
+            }
+        }
+    }
+
+    bool complete = queue.empty();
+
+    for (const Worker &worker : _workers) {
+        complete = complete && !worker.busy;
+    }
+    stop();
+
+    return complete;
+}
+
+/**
+ * @brief Print the statistics of the runs.
+ *
+ * This function prints the number of tiles rendered by every worker process
+ * over all the runs, and the number of tiles that had to be handed to
+ * another worker.
+ *
+ * @param out The output stream.
+ * @return void
+ */
+void Raytracer::Core::Coordinator::report(std::ostream &out) const
+{
+    out << std::format("Coordinator: {} process(es), {} tile(s) reassigned\n",
+        _workers.size(), _lost);
+
+    for (std::size_t i = 0; i < _workers.size(); i++) {
+        out << std::format("  process {:>2} (pid {}): {:>4} tiles\n", i,
+            _workers[i].pid, _workers[i].rendered);
+    }
+}
+
+/**
+ * @brief Fork the worker processes.
+ *
+ * This function forks every worker process, connected to the coordinator by
+ * a pair of Unix sockets. A worker closes the sockets of the workers forked
+ * before it, so that each of them sees the end of its own socket once the
+ * coordinator closes it. The statistics of the workers carry over from one
+ * run to the next.
+ *
+ * @param task The task run by the workers.
+ * @return true if every worker was forked, false otherwise.
+ */
+bool Raytracer::Core::Coordinator::spawn(const Task &task)
+{
+    for (int i = 0; i < _processes; i++) {
+        int sockets[2];
+
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) < 0) {
+            std::cerr << "ERROR: Could not create the socket of a worker"
+                      << std::endl;
+            return false;
+        }
+
+        std::cout << std::flush;
+        std::clog << std::flush;
+
+        pid_t pid = fork();
+
+        if (pid < 0) {
+            std::cerr << "ERROR: Could not fork a worker" << std::endl;
+            close(sockets[0]);
+            close(sockets[1]);
+            return false;
+        }
+
+        if (pid == 0) {
+            close(sockets[0]);
+            for (const Worker &worker : _workers) {
+                if (worker.socket >= 0) {
+                    close(worker.socket);
+                }
+            }
+            serve(sockets[1], task);
+        }
+
+        close(sockets[1]);
+        if (static_cast<std::size_t>(i) == _workers.size()) {
+            _workers.emplace_back();
+        }
+        _workers[i].pid = pid;
+        _workers[i].socket = sockets[0];
+        _workers[i].busy = false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Serve tiles in a worker process.
+ *
+ * This function is the body of a worker process. It receives tiles from the
+ * coordinator, runs the task on them and sends back the size of each result
+ * followed by the result, until the coordinator closes the socket.
+ *
+ * @param socket The socket connected to the coordinator.
+ * @param task The task to run on every tile.
+ * @return void
+ */
+void Raytracer::Core::Coordinator::serve(int socket, const Task &task) const
+{
+    std::int32_t bounds[4];
+
+    while (receive(socket, bounds, sizeof(bounds))) {
+        std::vector<char> result =
+            task(Tile(bounds[0], bounds[1], bounds[2], bounds[3]));
+        std::uint64_t size = result.size();
+
+        if (!send(socket, &size, sizeof(size))
+            || !send(socket, result.data(), result.size())) {
+            break;
+        }
+    }
+
+    close(socket);
+    _exit(0);
+}
+
+/**
+ * @brief Hand a tile to a worker.
+ *
+ * This function sends the bounds of the given tile to the worker. A worker
+ * that cannot be reached is dropped.
+ *
+ * @param worker The worker to hand the tile to.
+ * @param tile The tile to hand out.
+ * @return true if the tile was handed out, false otherwise.
+ */
+bool Raytracer::Core::Coordinator::dispatch(Worker &worker, const Tile &tile)
+{
+    std::int32_t bounds[4] = {
+        tile.x(), tile.y(), tile.width(), tile.height()};
+
+    if (!send(worker.socket, bounds, sizeof(bounds))) {
+        close(worker.socket);
+        worker.socket = -1;
+        return false;
+    }
+
+    worker.tile = tile;
+    worker.busy = true;
+
+    return true;
+}
+
+/**
+ * @brief Receive the result of the tile of a worker.
+ *
+ * This function reads the result of the tile the worker is busy with. A
+ * worker whose result cannot be read is dropped.
+ *
+ * @param worker The worker to read from.
+ * @param result The result of the tile.
+ * @return true if the result was received, false otherwise.
+ */
+bool Raytracer::Core::Coordinator::collect(
+    Worker &worker, std::vector<char> &result)
+{
+    std::uint64_t size = 0;
+
+    worker.busy = false;
+    if (!receive(worker.socket, &size, sizeof(size))) {
+        close(worker.socket);
+        worker.socket = -1;
+        return false;
+    }
+
+    result.resize(size);
+    if (!receive(worker.socket, result.data(), size)) {
+        close(worker.socket);
+        worker.socket = -1;
+        return false;
+    }
+
+    worker.rendered++;
+
+    return true;
+}
+
+/**
+ * @brief Stop the worker processes.
+ *
+ * This function closes the sockets of the workers, which makes them exit,
+ * and waits for every one of them.
+ *
+ * @return void
+ */
+void Raytracer::Core::Coordinator::stop()
+{
+    for (Worker &worker : _workers) {
+        if (worker.socket >= 0) {
+            close(worker.socket);
+            worker.socket = -1;
+        }
+    }
+    for (Worker &worker : _workers) {
+        if (worker.pid > 0) {
+            waitpid(worker.pid, nullptr, 0);
+        }
+    }
+}
+
+/**
+ * @brief Send a buffer over a socket.
+ *
+ * @param socket The socket to write to.
+ * @param data The buffer to send.
+ * @param size The size of the buffer.
+ * @return true if the whole buffer was sent, false otherwise.
+ */
+bool Raytracer::Core::Coordinator::send(
+    int socket, const void *data, std::size_t size)
+{
+    const char *bytes = static_cast<const char *>(data);
+
+    while (size > 0) {
+        ssize_t sent = ::send(socket, bytes, size, MSG_NOSIGNAL);
+
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= sent;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Receive a buffer from a socket.
+ *
+ * @param socket The socket to read from.
+ * @param data The buffer to fill.
+ * @param size The size of the buffer.
+ * @return true if the whole buffer was received, false otherwise.
+ */
+bool Raytracer::Core::Coordinator::receive(
+    int socket, void *data, std::size_t size)
+{
+    char *bytes = static_cast<char *>(data);
+
+    while (size > 0) {
+        ssize_t received = recv(socket, bytes, size, 0);
+
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= received;
+    }
+
+    return true;
+}
@@ -1,4 +1,5 @@
 #include "core/Scene.hpp"
+#include <algorithm>
 
 /**
  * @brief Construct a new Scene object.
@@ -54,7 +55,9 @@ void Raytracer::Core::Scene::add(std::shared_ptr<Interfaces::IHittable> object)
  * This function checks if the ray hits anything in the scene.
  * The function returns true if the ray hits anything in the scene.
  * The function returns false if the ray does not hit anything in the scene.
- * The function updates the payload with the hit information.
+ * The function updates the payload with the hit information. Objects only
+ * write to the payload when they are hit, so the closest hit is written in
+ * place without an intermediate copy.
  *
  * @param ray The ray to check for hits.
  * @param interval The interval to check for hits.
@@ -65,16 +68,15 @@ void Raytracer::Core::Scene::add(std::shared_ptr<Interfaces::IHittable> object)
 bool Raytracer::Core::Scene::hit(
     const Ray &ray, Utils::Interval interval, Payload &payload) const
 {
-    Payload temp;
     bool hitAnything = false;
     double closest = interval.max();
 
     for (const std::shared_ptr<Raytracer::Interfaces::IHittable> &object :
         _objects) {
-        if (object->hit(ray, Utils::Interval(interval.min(), closest), temp)) {
+        if (object->hit(
+                ray, Utils::Interval(interval.min(), closest), payload)) {
             hitAnything = true;
-            closest = temp.t();
-            payload = temp;
+            closest = payload.t();
         }
     }
 
@@ -92,3 +94,81 @@ Raytracer::Utils::AxisAlignedBBox Raytracer::Core::Scene::boundingBox() const
 {
     return _bbox;
 }
+
+/**
+ * @brief Check if the scene contains a light that can be sampled.
+ *
+ * This function returns true if any object of the scene is a light.
+ *
+ * @return true if the scene contains a light, false otherwise.
+ */
+bool Raytracer::Core::Scene::emissive() const
+{
+    return std::any_of(_objects.begin(), _objects.end(),
+        [](const std::shared_ptr<Interfaces::IHittable> &object) {
+            return object->emissive();
+        });
+}
+
+/**
+ * @brief Probability density of a direction towards the lights of the scene.
+ *
+ * This function returns the probability density of `random` generating the
+ * given direction from the given origin, which is the average of the
+ * densities of the lights of the scene.
+ *
+ * @param origin The origin of the direction.
+ * @param direction The direction to get the density of.
+ *
+ * @return The probability density of the direction.
+ */
+double Raytracer::Core::Scene::pdfValue(
+    const Utils::Point3 &origin, const Utils::Vec3 &direction) const
+{
+    double sum = 0;
+    int lights = 0;
+
+    for (const std::shared_ptr<Interfaces::IHittable> &object : _objects) {
+        if (object->emissive()) {
+            sum += object->pdfValue(origin, direction);
+            lights++;
+        }
+    }
+
+    return lights == 0 ? 0 : sum / lights;
+}
+
+/**
+ * @brief Random direction towards the lights of the scene.
+ *
+ * This function picks one of the lights of the scene uniformly and returns a
+ * random direction towards it. No random number is spent on the choice when
+ * the scene holds a single light.
+ *
+ * @param origin The origin of the direction.
+ *
+ * @return A random direction towards one of the lights.
+ */
+Raytracer::Utils::Vec3 Raytracer::Core::Scene::random(
+    const Utils::Point3 &origin) const
+{
+    int lights = 0;
+
+    for (const std::shared_ptr<Interfaces::IHittable> &object : _objects) {
+        lights += object->emissive();
+    }
+
+    if (lights == 0) {
+        return Utils::Vec3(1, 0, 0);
+    }
+
+    int index = (lights > 1) ? Utils::randomInt(0, lights - 1) : 0;
+
+    for (const std::shared_ptr<Interfaces::IHittable> &object : _objects) {
+        if (object->emissive() && index-- == 0) {
+            return object->random(origin);
+        }
+    }
+
+    return Utils::Vec3(1, 0, 0);
+}
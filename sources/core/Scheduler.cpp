@@ -0,0 +1,264 @@
+#include "core/Scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <thread>
+
+/**
+ * @brief Construct a new Scheduler object.
+ *
+ * This function constructs a new Scheduler object with one worker per thread.
+ * Every worker owns a double-ended queue of tiles. A worker takes tiles from
+ * the front of its own queue and, once it runs dry, steals tiles from the
+ * back of the queues of the other workers.
+ *
+ * @param threads The number of worker threads.
+ * @param order The order in which the tiles are handed out.
+ * @param tileSize The size of the tiles, the spacing of the tile grid.
+ *
+ * @return A new Scheduler object.
+ */
+Raytracer::Core::Scheduler::Scheduler(
+    int threads, TileOrder order, int tileSize)
+    : _order(order), _tileSize(std::max(1, tileSize))
+{
+    for (int i = 0; i < std::max(1, threads); i++) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+/**
+ * @brief Run the given task on every tile.
+ *
+ * This function sorts the tiles in the configured order and deals them out
+ * in contiguous runs to the queues of the workers, so that neighbouring tiles
+ * are rendered by the same thread. The workers then process their queues and
+ * steal from each other until every tile is done. The function returns once
+ * all the tiles have been processed.
+ *
+ * @param tiles The tiles to process.
+ * @param task The task to run on every tile.
+ * @return void
+ */
+void Raytracer::Core::Scheduler::run(
+    std::vector<Tile> tiles, const std::function<void(const Tile &)> &task)
+{
+    std::size_t count = _workers.size();
+
+    sort(tiles);
+    for (std::size_t t = 0; t < tiles.size(); t++) {
+        _workers[t * count / tiles.size()]->tiles.push_back(tiles[t]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (count == 1) {
+        work(0, task);
+    } else {
+        std::vector<std::thread> pool;
+
+        for (std::size_t i = 0; i < count; i++) {
+            pool.emplace_back(&Scheduler::work, this, i, std::cref(task));
+        }
+        for (std::thread &thread : pool) {
+            thread.join();
+        }
+    }
+
+    _elapsed += std::chrono::steady_clock::now() - start;
+    for (std::unique_ptr<Worker> &worker : _workers) {
+        worker->idle = _elapsed - worker->busy;
+    }
+}
+
+/**
+ * @brief Process tiles until there is no work left.
+ *
+ * This function is the body of a worker thread. It pops tiles from its own
+ * queue, falls back to stealing from the other workers and accumulates the
+ * time spent running the task.
+ *
+ * @param index The index of the worker.
+ * @param task The task to run on every tile.
+ * @return void
+ */
+void Raytracer::Core::Scheduler::work(
+    int index, const std::function<void(const Tile &)> &task)
+{
+    Worker &worker = *_workers[index];
+    Tile tile;
+
+    while (pop(index, tile) || steal(index, tile)) {
+        auto begin = std::chrono::steady_clock::now();
+
+        task(tile);
+        worker.busy += std::chrono::steady_clock::now() - begin;
+        worker.rendered++;
+    }
+}
+
+/**
+ * @brief Pop a tile from the front of the queue of a worker.
+ *
+ * @param index The index of the worker.
+ * @param tile The tile to fill.
+ * @return true if a tile was popped, false if the queue is empty.
+ */
+bool Raytracer::Core::Scheduler::pop(int index, Tile &tile)
+{
+    Worker &worker = *_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+
+    if (worker.tiles.empty()) {
+        return false;
+    }
+
+    tile = worker.tiles.front();
+    worker.tiles.pop_front();
+
+    return true;
+}
+
+/**
+ * @brief Steal a tile from the back of the queue of another worker.
+ *
+ * This function visits the other workers in turn, starting with the next
+ * one, and takes the last tile of the first non-empty queue it finds.
+ *
+ * @param index The index of the stealing worker.
+ * @param tile The tile to fill.
+ * @return true if a tile was stolen, false if every queue is empty.
+ */
+bool Raytracer::Core::Scheduler::steal(int index, Tile &tile)
+{
+    int count = static_cast<int>(_workers.size());
+
+    for (int offset = 1; offset < count; offset++) {
+        Worker &victim = *_workers[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (victim.tiles.empty()) {
+            continue;
+        }
+
+        tile = victim.tiles.back();
+        victim.tiles.pop_back();
+        _workers[index]->stolen++;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Print the statistics of the runs.
+ *
+ * This function prints, for every worker, the number of tiles it rendered,
+ * how many of them were stolen, and the time it spent busy and idle over all
+ * the runs of the scheduler. The idle time is the part of the runs during
+ * which the worker had nothing to do, which is mostly the tail of each frame
+ * or pass.
+ *
+ * @param out The output stream.
+ * @return void
+ */
+void Raytracer::Core::Scheduler::report(std::ostream &out) const
+{
+    out << std::format("Scheduler: {} thread(s), {:.3f}s wall time\n",
+        _workers.size(), _elapsed.count());
+
+    for (std::size_t i = 0; i < _workers.size(); i++) {
+        const Worker &worker = *_workers[i];
+        double busy = worker.busy.count();
+        double idle = worker.idle.count();
+
+        out << std::format(
+            "  thread {:>2}: {:>4} tiles ({:>3} stolen), busy {:.3f}s, idle "
+            "{:.3f}s ({:.1f}%)\n",
+            i, worker.rendered, worker.stolen, busy, idle,
+            _elapsed.count() > 0 ? 100.0 * idle / _elapsed.count() : 0.0);
+    }
+}
+
+/**
+ * @brief Sort the tiles in the configured order.
+ *
+ * In Morton order, the tiles follow a Z-order curve over the tile grid, which
+ * keeps consecutive tiles close together in the image. In spiral order, the
+ * tiles are sorted by ring around the center of the image, so the middle of
+ * the frame is rendered first. In scanline order, the tiles are left as is.
+ * The grid has the nominal tile size as its spacing and starts at the top
+ * left tile, so that tiles clipped by the edges of the image or of the
+ * rendered region keep their place on it.
+ *
+ * @param tiles The tiles to sort.
+ * @return void
+ */
+void Raytracer::Core::Scheduler::sort(std::vector<Tile> &tiles) const
+{
+    if (tiles.empty() || _order == TileOrder::ORDER_SCANLINE) {
+        return;
+    }
+
+    int size = _tileSize;
+    int left = tiles[0].x();
+    int top = tiles[0].y();
+
+    for (const Tile &tile : tiles) {
+        left = std::min(left, tile.x());
+        top = std::min(top, tile.y());
+    }
+
+    if (_order == TileOrder::ORDER_MORTON) {
+        std::stable_sort(tiles.begin(), tiles.end(),
+            [size, left, top](const Tile &a, const Tile &b) {
+                return mortonCode((a.x() - left) / size, (a.y() - top) / size)
+                    < mortonCode(
+                        (b.x() - left) / size, (b.y() - top) / size);
+            });
+        return;
+    }
+
+    double cx = 0;
+    double cy = 0;
+    for (const Tile &tile : tiles) {
+        cx = std::max(cx, static_cast<double>((tile.x() - left) / size));
+        cy = std::max(cy, static_cast<double>((tile.y() - top) / size));
+    }
+    cx /= 2;
+    cy /= 2;
+
+    auto key = [size, left, top, cx, cy](const Tile &tile) {
+        double dx = (tile.x() - left) / size - cx;
+        double dy = (tile.y() - top) / size - cy;
+        double ring = std::ceil(std::max(std::fabs(dx), std::fabs(dy)));
+
+        return std::make_pair(ring, std::atan2(dy, dx));
+    };
+
+    std::stable_sort(tiles.begin(), tiles.end(),
+        [&key](const Tile &a, const Tile &b) { return key(a) < key(b); });
+}
+
+/**
+ * @brief Compute the Morton code of a tile.
+ *
+ * This function interleaves the bits of the tile coordinates, giving the
+ * position of the tile along a Z-order curve.
+ *
+ * @param x The column of the tile.
+ * @param y The row of the tile.
+ * @return The Morton code of the tile.
+ */
+std::uint32_t Raytracer::Core::Scheduler::mortonCode(int x, int y)
+{
+    std::uint32_t code = 0;
+
+    for (int bit = 0; bit < 16; bit++) {
+        code |= ((static_cast<std::uint32_t>(x) >> bit) & 1) << (2 * bit);
+        code |= ((static_cast<std::uint32_t>(y) >> bit) & 1) << (2 * bit + 1);
+    }
+
+    return code;
+}
@@ -0,0 +1,20 @@
+#include "core/Tile.hpp"
+
+/**
+ * @brief Construct a new Tile object.
+ *
+ * This function constructs a new Tile object with the given position and
+ * size. A tile is a rectangular region of the image that is rendered as a
+ * single unit of work.
+ *
+ * @param x The x coordinate of the top left pixel of the tile.
+ * @param y The y coordinate of the top left pixel of the tile.
+ * @param width The width of the tile in pixels.
+ * @param height The height of the tile in pixels.
+ *
+ * @return A new Tile object.
+ */
+Raytracer::Core::Tile::Tile(int x, int y, int width, int height)
+    : _x(x), _y(y), _width(width), _height(height)
+{
+}
@@ -101,7 +101,7 @@ bool Raytracer::Effects::Smoke::hit(const Core::Ray &ray,
 
     payload.normal(Utils::Vec3(1, 0, 0));
     payload.frontFace(true);
-    payload.material(_phaseFunction);
+    payload.material(_phaseFunction.get());
 
     return true;
 }
@@ -0,0 +1,158 @@
+#include "effects/Transform.hpp"
+
+/**
+ * @brief Construct a new Transform object.
+ *
+ * This function constructs a new Transform object drawing the given object
+ * moved by the given affine transform. The object is shared and is never
+ * copied, so that many instances of a complex object, each with its own
+ * transform, cost the memory of a single copy of it. A transform of a
+ * transform is folded into a single one, so that a chain of rotations and
+ * translations costs one change of space per ray instead of one per link.
+ * The transform must not be degenerate.
+ *
+ * @param object The object to transform.
+ * @param transform The transform from the space of the object to the world.
+ *
+ * @return A new Transform object.
+ */
+Raytracer::Effects::Transform::Transform(
+    std::shared_ptr<Interfaces::IHittable> object,
+    const Utils::Affine &transform)
+    : _object(object), _transform(transform)
+{
+    std::shared_ptr<Transform> inner =
+        std::dynamic_pointer_cast<Transform>(object);
+
+    if (inner) {
+        _object = inner->_object;
+        _transform = transform * inner->_transform;
+    }
+    _inverse = _transform.inverse();
+    _bbox = _transform.box(_object->boundingBox());
+}
+
+/**
+ * @brief Check if the ray hits the transformed object.
+ *
+ * This function brings the ray into the space of the object with the
+ * inverse transform and intersects it with the object. The direction of the
+ * ray is not normalized, so that the distance along the ray, and thus the
+ * interval, are the same in both spaces. The point of the hit is moved back
+ * into the world, and its normal is transformed by the inverse transpose of
+ * the transform so that it stays perpendicular to the surface.
+ *
+ * @param ray The ray to check for hits.
+ * @param interval The interval to check for hits.
+ * @param payload The payload to update with the hit information.
+ *
+ * @return true if the ray hits the transformed object, false otherwise.
+ */
+bool Raytracer::Effects::Transform::hit(const Core::Ray &ray,
+    Utils::Interval interval, Core::Payload &payload) const
+{
+    Core::Ray local(_inverse.point(ray.origin()),
+        _inverse.vector(ray.direction()), ray.time());
+
+    if (!_object->hit(local, interval, payload)) {
+        return false;
+    }
+
+    payload.point(_transform.point(payload.point()));
+    payload.normal(unitVector(_inverse.transposed(payload.normal())));
+
+    return true;
+}
+
+/**
+ * @brief Get the bounding box of the transformed object.
+ *
+ * This function returns the bounding box of the transformed object.
+ *
+ * @return The bounding box of the transformed object.
+ */
+Raytracer::Utils::AxisAlignedBBox
+Raytracer::Effects::Transform::boundingBox() const
+{
+    return _bbox;
+}
+
+/**
+ * @brief Check if the transformed object is a light that can be sampled.
+ *
+ * This function returns true if the object is a light and the transform
+ * preserves angles. Any other transform changes the solid angle under which
+ * the object is seen, so its density would be wrong and the transformed
+ * object only lights the scene when rays hit it.
+ *
+ * @return true if the transformed object is a light, false otherwise.
+ */
+bool Raytracer::Effects::Transform::emissive() const
+{
+    return _object->emissive() && _transform.similarity();
+}
+
+/**
+ * @brief Probability density of a direction towards the transformed object.
+ *
+ * This function brings the origin and the direction into the space of the
+ * object and returns the probability density of the object for them. The
+ * object is only sampled when the transform preserves angles, which leaves
+ * the density unchanged.
+ *
+ * @param origin The origin of the direction.
+ * @param direction The direction to get the density of.
+ *
+ * @return The probability density of the direction.
+ */
+double Raytracer::Effects::Transform::pdfValue(
+    const Utils::Point3 &origin, const Utils::Vec3 &direction) const
+{
+    return _object->pdfValue(
+        _inverse.point(origin), _inverse.vector(direction));
+}
+
+/**
+ * @brief Random direction towards the transformed object.
+ *
+ * This function brings the origin into the space of the object, generates a
+ * random direction towards the object and transforms it back into the
+ * world.
+ *
+ * @param origin The origin of the direction.
+ *
+ * @return A random direction towards the transformed object.
+ */
+Raytracer::Utils::Vec3 Raytracer::Effects::Transform::random(
+    const Utils::Point3 &origin) const
+{
+    return _transform.vector(_object->random(_inverse.point(origin)));
+}
+
+/**
+ * @brief Get the transformed object.
+ *
+ * This function returns the object drawn by the transform, which is never
+ * itself a transform.
+ *
+ * @return The transformed object.
+ */
+std::shared_ptr<Raytracer::Interfaces::IHittable>
+Raytracer::Effects::Transform::object() const
+{
+    return _object;
+}
+
+/**
+ * @brief Get the transform.
+ *
+ * This function returns the transform from the space of the object to the
+ * world.
+ *
+ * @return The transform.
+ */
+const Raytracer::Utils::Affine &
+Raytracer::Effects::Transform::transform() const
+{
+    return _transform;
+}
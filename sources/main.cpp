@@ -1,11 +1,30 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "config/Daemon.hpp"
 #include "config/Manager.hpp"
+#include "config/Watcher.hpp"
+#include "utils/MeshData.hpp"
+#include "utils/Random.hpp"
 
 int main(int argc, char **argv)
 {
     Raytracer::Config::Manager manager;
 
     std::string usage = "Usage: " + std::string(argv[0])
-        + " [--fast] --config <config file>\n";
+        + " [--fast] [--stats] [--benchmark] [--threads <count>]"
+          " [--seed <seed>]"
+          " [--tile-order <scanline|morton|spiral>] [--sample-map <file>]"
+          " [--output <file>] [--checkpoint <file>]"
+          " [--checkpoint-interval <seconds>] [--resume] [--progressive]"
+          " [--pass-samples <count>] [--time-budget <seconds>]"
+          " [--target-noise <threshold>] [--preview-interval <seconds>]"
+          " [--region <x0,y0,x1,y1>] [--samples-from <index>]"
+          " [--samples-to <index>] [--partial <file>] [--merge <file>]..."
+          " [--coordinator <processes>] [--daemon <socket>] [--watch]"
+          " [--mesh-cache <directory>]"
+          " --config <config file>\n";
 
     if (argc < 2) {
         std::cerr << usage;
@@ -18,7 +37,31 @@ int main(int argc, char **argv)
     }
 
     bool fast = false;
+    bool stats = false;
+    bool benchmark = false;
     std::string path = "/dev/null";
+    int threads = std::max(1U, std::thread::hardware_concurrency());
+    std::uint64_t seed = 0;
+    std::string sampleMap;
+    std::string output;
+    std::string checkpoint;
+    double interval = 300;
+    bool resume = false;
+    bool progressive = false;
+    int passSamples = 1;
+    double budget = 0;
+    double noise = -1;
+    double preview = 10;
+    Raytracer::Core::Tile region;
+    int samplesFrom = 0;
+    int samplesTo = 0;
+    std::string partial;
+    std::vector<std::string> merges;
+    int processes = 0;
+    std::string daemon;
+    bool watch = false;
+    Raytracer::Core::TileOrder order =
+        Raytracer::Core::TileOrder::ORDER_MORTON;
 
     for (int i = 1; i < argc; i++) {
         if (std::string(argv[i]) == "--config") {
@@ -27,17 +70,243 @@ int main(int argc, char **argv)
             }
         } else if (std::string(argv[i]) == "--fast") {
             fast = true;
+        } else if (std::string(argv[i]) == "--threads") {
+            if (i + 1 < argc) {
+                threads = std::atoi(argv[i + 1]);
+            }
+            if (threads < 1) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--tile-order") {
+            std::string name = (i + 1 < argc) ? argv[i + 1] : "";
+
+            if (name == "scanline") {
+                order = Raytracer::Core::TileOrder::ORDER_SCANLINE;
+            } else if (name == "morton") {
+                order = Raytracer::Core::TileOrder::ORDER_MORTON;
+            } else if (name == "spiral") {
+                order = Raytracer::Core::TileOrder::ORDER_SPIRAL;
+            } else {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--stats") {
+            stats = true;
+        } else if (std::string(argv[i]) == "--benchmark") {
+            benchmark = true;
+        } else if (std::string(argv[i]) == "--seed") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            seed = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::string(argv[i]) == "--sample-map") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            sampleMap = argv[i + 1];
+        } else if (std::string(argv[i]) == "--output") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            output = argv[i + 1];
+        } else if (std::string(argv[i]) == "--checkpoint") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            checkpoint = argv[i + 1];
+        } else if (std::string(argv[i]) == "--checkpoint-interval") {
+            if (i + 1 < argc) {
+                interval = std::atof(argv[i + 1]);
+            }
+            if (interval <= 0) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--resume") {
+            resume = true;
+        } else if (std::string(argv[i]) == "--progressive") {
+            progressive = true;
+        } else if (std::string(argv[i]) == "--pass-samples") {
+            if (i + 1 < argc) {
+                passSamples = std::atoi(argv[i + 1]);
+            }
+            if (passSamples < 1) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--time-budget") {
+            if (i + 1 < argc) {
+                budget = std::atof(argv[i + 1]);
+            }
+            if (budget <= 0) {
+                std::cerr << usage;
+                return 84;
+            }
+            progressive = true;
+        } else if (std::string(argv[i]) == "--target-noise") {
+            if (i + 1 < argc) {
+                noise = std::atof(argv[i + 1]);
+            }
+            if (noise <= 0) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--preview-interval") {
+            if (i + 1 < argc) {
+                preview = std::atof(argv[i + 1]);
+            }
+            if (preview <= 0) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--region") {
+            int x0 = 0;
+            int y0 = 0;
+            int x1 = 0;
+            int y1 = 0;
+
+            if (i + 1 >= argc
+                || std::sscanf(argv[i + 1], "%d,%d,%d,%d", &x0, &y0, &x1, &y1)
+                    != 4
+                || x1 <= x0 || y1 <= y0) {
+                std::cerr << usage;
+                return 84;
+            }
+            region = Raytracer::Core::Tile(x0, y0, x1 - x0, y1 - y0);
+        } else if (std::string(argv[i]) == "--samples-from") {
+            if (i + 1 < argc) {
+                samplesFrom = std::atoi(argv[i + 1]);
+            }
+            if (samplesFrom < 0) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--samples-to") {
+            if (i + 1 < argc) {
+                samplesTo = std::atoi(argv[i + 1]);
+            }
+            if (samplesTo < 1) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--partial") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            partial = argv[i + 1];
+        } else if (std::string(argv[i]) == "--merge") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            merges.push_back(argv[i + 1]);
+        } else if (std::string(argv[i]) == "--coordinator") {
+            if (i + 1 < argc) {
+                processes = std::atoi(argv[i + 1]);
+            }
+            if (processes < 1) {
+                std::cerr << usage;
+                return 84;
+            }
+        } else if (std::string(argv[i]) == "--daemon") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            daemon = argv[i + 1];
+        } else if (std::string(argv[i]) == "--watch") {
+            watch = true;
+            progressive = true;
+        } else if (std::string(argv[i]) == "--mesh-cache") {
+            if (i + 1 >= argc) {
+                std::cerr << usage;
+                return 84;
+            }
+            Raytracer::Utils::MeshData::cacheDirectory(argv[i + 1]);
         }
     }
 
+    if (!merges.empty()) {
+        Raytracer::Core::Camera camera;
+
+        camera.output(output);
+        return camera.merge(merges) ? 0 : 84;
+    }
+
+    if (resume && checkpoint.empty()) {
+        std::cerr << usage;
+        return 84;
+    }
+
+    Raytracer::Utils::Random::local().seed(seed);
+
+    if (!daemon.empty()) {
+        Raytracer::Core::Camera defaults;
+
+        defaults.threads(threads);
+        defaults.tileOrder(order);
+        defaults.processes(processes);
+        defaults.statistics(stats);
+        defaults.seed(seed);
+
+        Raytracer::Config::Daemon server(daemon, defaults);
+
+        return server.run() ? 0 : 84;
+    }
+
+    auto setup = [&](Raytracer::Config::Manager &manager) {
+        manager.camera().threads(threads);
+        manager.camera().tileOrder(order);
+        manager.camera().statistics(stats);
+        manager.camera().seed(seed);
+        manager.camera().sampleMap(sampleMap);
+        manager.camera().output(output);
+        manager.camera().checkpoint(checkpoint);
+        manager.camera().checkpointInterval(interval);
+        manager.camera().resume(resume);
+        manager.camera().progressive(progressive);
+        manager.camera().passSamples(passSamples);
+        manager.camera().timeBudget(budget);
+        manager.camera().previewInterval(preview);
+        manager.camera().region(region);
+        manager.camera().samplesFrom(samplesFrom);
+        manager.camera().samplesTo(samplesTo);
+        manager.camera().partial(partial);
+        manager.camera().processes(processes);
+        if (noise > 0) {
+            manager.camera().adaptiveThreshold(noise);
+        }
+        manager.bootstrap();
+    };
+
+    if (watch) {
+        Raytracer::Config::Watcher watcher(path, setup, fast);
+
+        return watcher.run() ? 0 : 84;
+    }
+
     bool success = manager.parse(path);
 
     if (!success) {
         return 84;
     }
 
-    manager.bootstrap();
-    manager.render(fast);
+    setup(manager);
+
+    if (benchmark) {
+        manager.benchmark(fast);
+        return 0;
+    }
+
+    if (!manager.render(fast)) {
+        return 84;
+    }
 
     return 0;
 }
@@ -70,3 +70,16 @@ Raytracer::Utils::Color Raytracer::Materials::DiffuseLight::emitted(
 {
     return _texture->value(u, v, point);
 }
+
+/**
+ * @brief Check if the diffuse light material emits light.
+ *
+ * This function returns true, the diffuse light material is an emitter that
+ * can be sampled directly by the camera.
+ *
+ * @return true.
+ */
+bool Raytracer::Materials::DiffuseLight::emits() const
+{
+    return true;
+}
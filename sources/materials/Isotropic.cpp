@@ -72,3 +72,22 @@ Raytracer::Utils::Color Raytracer::Materials::Isotropic::emitted(
 {
     return Utils::Color(0.0, 0.0, 0.0);
 }
+
+/**
+ * @brief Probability density of a scattered ray of the isotropic material.
+ *
+ * This function returns the probability density, with respect to solid
+ * angle, of the isotropic material scattering the ray in the direction of
+ * the given scattered ray. Every direction is equally likely.
+ *
+ * @param ray The incoming ray.
+ * @param payload The payload of the ray.
+ * @param scattered The scattered ray.
+ *
+ * @return The probability density of the scattered direction.
+ */
+double Raytracer::Materials::Isotropic::scatteringPdf(const Core::Ray &ray,
+    const Core::Payload &payload, const Core::Ray &scattered) const
+{
+    return 1 / (4 * M_PI);
+}
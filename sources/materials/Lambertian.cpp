@@ -80,3 +80,26 @@ Raytracer::Utils::Color Raytracer::Materials::Lambertian::emitted(
 {
     return Utils::Color(0.0, 0.0, 0.0);
 }
+
+/**
+ * @brief Probability density of a scattered ray of the Lambertian material.
+ *
+ * This function returns the probability density, with respect to solid
+ * angle, of the Lambertian material scattering the ray in the direction of
+ * the given scattered ray. The scattered directions are cosine weighted
+ * around the normal.
+ *
+ * @param ray The incoming ray.
+ * @param payload The payload of the ray.
+ * @param scattered The scattered ray.
+ *
+ * @return The probability density of the scattered direction.
+ */
+double Raytracer::Materials::Lambertian::scatteringPdf(const Core::Ray &ray,
+    const Core::Payload &payload, const Core::Ray &scattered) const
+{
+    double cosine =
+        dot(payload.normal(), Utils::unitVector(scattered.direction()));
+
+    return cosine < 0 ? 0 : cosine / M_PI;
+}
@@ -0,0 +1,166 @@
+#include "samplers/BlueNoise.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "utils/Random.hpp"
+
+/**
+ * @brief Get a value of the blue noise sequence of a pixel.
+ *
+ * This function returns the given dimension of the sample `index` of the
+ * pixel (x, y). All the pixels share the same Owen-scrambled Sobol sequence,
+ * shifted toroidally by the value of a blue noise mask at the pixel. The mask
+ * is offset differently for every dimension. Neighbouring pixels thus get
+ * sample sets that are shifted as differently as possible, which spreads the
+ * error of the image as high-frequency noise that is far less visible at low
+ * sample counts.
+ *
+ * @param seed The global seed.
+ * @param x The x coordinate of the pixel.
+ * @param y The y coordinate of the pixel.
+ * @param index The index of the sample within the pixel.
+ * @param dimension The dimension of the sample.
+ *
+ * @return A value in [0, 1).
+ */
+double Raytracer::Samplers::BlueNoise::value(std::uint64_t seed, int x, int y,
+    std::uint32_t index, std::uint32_t dimension) const
+{
+    std::uint64_t offset =
+        Utils::Random::mix(seed ^ ~static_cast<std::uint64_t>(dimension));
+    int column = (x + static_cast<int>(offset & (size - 1))) & (size - 1);
+    int row = (y + static_cast<int>((offset >> 32) & (size - 1))) & (size - 1);
+    double value = sample(Utils::Random::mix(seed), index, dimension)
+        + mask()[row * size + column];
+
+    return value < 1 ? value : value - 1;
+}
+
+/**
+ * @brief Get the blue noise mask.
+ *
+ * This function returns the blue noise mask shared by all the blue noise
+ * samplers. It is generated on first use.
+ *
+ * @return The values of the mask in [0, 1), row by row.
+ */
+const std::vector<float> &Raytracer::Samplers::BlueNoise::mask()
+{
+    static const std::vector<float> values = generate();
+
+    return values;
+}
+
+/**
+ * @brief Generate a blue noise mask.
+ *
+ * This function generates a tileable blue noise mask with the
+ * void-and-cluster method from Ulichney. The energy of a pixel is the sum of
+ * a Gaussian of its toroidal distance to every set pixel. A random initial
+ * pattern is first relaxed by moving its tightest cluster to its largest void
+ * until they coincide. The pixels of the pattern are then ranked by removing
+ * tightest clusters one by one, and the remaining pixels by filling largest
+ * voids one by one. The rank of a pixel, normalised, is its value.
+ *
+ * @return The values of the mask in [0, 1), row by row.
+ */
+std::vector<float> Raytracer::Samplers::BlueNoise::generate()
+{
+    constexpr int count = size * size;
+    constexpr double sigma = 1.5;
+    std::vector<double> kernel(count);
+    std::vector<double> energy(count, 0);
+    std::vector<bool> pattern(count, false);
+    std::vector<int> rank(count);
+    Utils::Random generator(0x5eed);
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int dx = std::min(x, size - x);
+            int dy = std::min(y, size - y);
+
+            kernel[y * size + x] =
+                std::exp(-(dx * dx + dy * dy) / (2 * sigma * sigma));
+        }
+    }
+
+    auto toggle = [&](int pixel) {
+        double sign = pattern[pixel] ? -1 : 1;
+        int px = pixel % size;
+        int py = pixel / size;
+
+        pattern[pixel] = !pattern[pixel];
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                energy[y * size + x] += sign
+                    * kernel[((y - py) & (size - 1)) * size
+                        + ((x - px) & (size - 1))];
+            }
+        }
+    };
+    auto extreme = [&](bool set) {
+        int best = -1;
+
+        for (int pixel = 0; pixel < count; pixel++) {
+            if (pattern[pixel] == set
+                && (best < 0
+                    || (set ? energy[pixel] > energy[best]
+                            : energy[pixel] < energy[best]))) {
+                best = pixel;
+            }
+        }
+        return best;
+    };
+
+    int ones = count / 10;
+
+    for (int placed = 0; placed < ones;) {
+        int pixel = static_cast<int>(generator.next() % count);
+
+        if (!pattern[pixel]) {
+            toggle(pixel);
+            placed++;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        int cluster = extreme(true);
+
+        toggle(cluster);
+
+        int voidPixel = extreme(false);
+
+        toggle(voidPixel);
+        if (voidPixel == cluster) {
+            break;
+        }
+    }
+
+    std::vector<bool> prototype = pattern;
+    std::vector<double> prototypeEnergy = energy;
+
+    for (int r = ones - 1; r >= 0; r--) {
+        int cluster = extreme(true);
+
+        toggle(cluster);
+        rank[cluster] = r;
+    }
+
+    pattern = prototype;
+    energy = prototypeEnergy;
+
+    for (int r = ones; r < count; r++) {
+        int voidPixel = extreme(false);
+
+        toggle(voidPixel);
+        rank[voidPixel] = r;
+    }
+
+    std::vector<float> values(count);
+
+    for (int pixel = 0; pixel < count; pixel++) {
+        values[pixel] = (rank[pixel] + 0.5f) / count;
+    }
+
+    return values;
+}
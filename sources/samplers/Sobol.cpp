@@ -0,0 +1,112 @@
+#include "samplers/Sobol.hpp"
+#include "utils/Random.hpp"
+
+/**
+ * @brief Get a value of the Owen-scrambled Sobol sequence of a pixel.
+ *
+ * This function returns the given dimension of the sample `index` of the
+ * pixel (x, y). Every pixel gets its own scrambling of the sequence, so
+ * neighbouring pixels are decorrelated while the samples of a pixel stay
+ * well stratified.
+ *
+ * @param seed The global seed.
+ * @param x The x coordinate of the pixel.
+ * @param y The y coordinate of the pixel.
+ * @param index The index of the sample within the pixel.
+ * @param dimension The dimension of the sample.
+ *
+ * @return A value in [0, 1).
+ */
+double Raytracer::Samplers::Sobol::value(std::uint64_t seed, int x, int y,
+    std::uint32_t index, std::uint32_t dimension) const
+{
+    std::uint64_t pixel = (static_cast<std::uint64_t>(y) << 32)
+        | static_cast<std::uint32_t>(x);
+
+    return sample(Utils::Random::mix(seed ^ Utils::Random::mix(pixel)),
+        index, dimension);
+}
+
+/**
+ * @brief Get a value of an Owen-scrambled Sobol sequence.
+ *
+ * This function pads the sequence out of two-dimensional Sobol points: the
+ * dimensions are grouped in pairs, each pair taking the first two dimensions
+ * of the Sobol sequence at an index shuffled independently for that pair.
+ * Both the index and the resulting value are Owen-scrambled with hashed
+ * seeds, so any number of dimensions can be drawn without a table of
+ * direction numbers, and every pair of dimensions is a (0, 2)-sequence.
+ *
+ * @param seed The seed of the scrambling.
+ * @param index The index of the sample.
+ * @param dimension The dimension of the sample.
+ *
+ * @return A value in [0, 1).
+ */
+double Raytracer::Samplers::Sobol::sample(
+    std::uint64_t seed, std::uint32_t index, std::uint32_t dimension)
+{
+    std::uint64_t hash = Utils::Random::mix(seed ^ (dimension / 2));
+    std::uint32_t shuffled =
+        scramble(index, static_cast<std::uint32_t>(hash));
+    std::uint32_t value = 0;
+
+    if (dimension % 2 == 0) {
+        value = reverse(shuffled);
+    } else {
+        for (std::uint32_t direction = 0x80000000u; shuffled != 0;
+            shuffled >>= 1, direction ^= direction >> 1) {
+            if (shuffled & 1) {
+                value ^= direction;
+            }
+        }
+    }
+
+    value = scramble(
+        value, static_cast<std::uint32_t>(hash >> 32) + dimension % 2);
+
+    return value * 0x1.0p-32;
+}
+
+/**
+ * @brief Owen-scramble a 32-bit value.
+ *
+ * This function applies a nested uniform scramble to the bits of the value,
+ * most significant bit first, using the hash-based permutation from Burley,
+ * "Practical Hash-based Owen Scrambling".
+ *
+ * @param value The value to scramble.
+ * @param seed The seed of the scrambling.
+ *
+ * @return The scrambled value.
+ */
+std::uint32_t Raytracer::Samplers::Sobol::scramble(
+    std::uint32_t value, std::uint32_t seed)
+{
+    value = reverse(value);
+    value ^= value * 0x3d20adeau;
+    value += seed;
+    value *= (seed >> 16) | 1;
+    value ^= value * 0x05526c56u;
+    value ^= value * 0x53a22864u;
+
+    return reverse(value);
+}
+
+/**
+ * @brief Reverse the bits of a 32-bit value.
+ *
+ * @param value The value to reverse.
+ *
+ * @return The value with its bits in reverse order.
+ */
+std::uint32_t Raytracer::Samplers::Sobol::reverse(std::uint32_t value)
+{
+    value = (value << 16) | (value >> 16);
+    value = ((value & 0x00ff00ffu) << 8) | ((value & 0xff00ff00u) >> 8);
+    value = ((value & 0x0f0f0f0fu) << 4) | ((value & 0xf0f0f0f0u) >> 4);
+    value = ((value & 0x33333333u) << 2) | ((value & 0xccccccccu) >> 2);
+    value = ((value & 0x55555555u) << 1) | ((value & 0xaaaaaaaau) >> 1);
+
+    return value;
+}
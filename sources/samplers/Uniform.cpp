@@ -0,0 +1,23 @@
+#include "samplers/Uniform.hpp"
+#include "utils/Random.hpp"
+
+/**
+ * @brief Get a uniform random value.
+ *
+ * This function ignores the sample coordinates and draws an independent
+ * uniform random number from the generator of the calling thread, which the
+ * camera reseeds for every pixel sample.
+ *
+ * @param seed The global seed.
+ * @param x The x coordinate of the pixel.
+ * @param y The y coordinate of the pixel.
+ * @param index The index of the sample within the pixel.
+ * @param dimension The dimension of the sample.
+ *
+ * @return A random double in [0, 1).
+ */
+double Raytracer::Samplers::Uniform::value(std::uint64_t seed, int x, int y,
+    std::uint32_t index, std::uint32_t dimension) const
+{
+    return Utils::Random::local().nextDouble();
+}
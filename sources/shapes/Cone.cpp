@@ -63,7 +63,7 @@ bool Raytracer::Shapes::Cone::hit(const Core::Ray &ray,
             payload.t(t);
             payload.point(ray.at(payload.t()));
             payload.setFaceNormal(ray, Utils::Vec3(0, 1, 0));
-            payload.material(_material);
+            payload.material(_material.get());
             return true;
         }
     }
@@ -93,7 +93,7 @@ bool Raytracer::Shapes::Cone::hit(const Core::Ray &ray,
     normal = Utils::unitVector(normal);
 
     payload.setFaceNormal(ray, normal);
-    payload.material(_material);
+    payload.material(_material.get());
 
     return true;
 }
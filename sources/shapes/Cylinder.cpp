@@ -53,7 +53,7 @@ bool Raytracer::Shapes::Cylinder::hit(const Core::Ray &ray,
             payload.t(t_cap);
             payload.point(hit_point);
             payload.setFaceNormal(ray, Utils::Vec3(0, 1, 0));
-            payload.material(_material);
+            payload.material(_material.get());
             return true;
         }
     }
@@ -68,7 +68,7 @@ bool Raytracer::Shapes::Cylinder::hit(const Core::Ray &ray,
             payload.t(t_cap);
             payload.point(hit_point);
             payload.setFaceNormal(ray, Utils::Vec3(0, -1, 0));
-            payload.material(_material);
+            payload.material(_material.get());
             return true;
         }
     }
@@ -109,7 +109,7 @@ bool Raytracer::Shapes::Cylinder::hit(const Core::Ray &ray,
     normal = normal.normalize();
 
     payload.setFaceNormal(ray, normal);
-    payload.material(_material);
+    payload.material(_material.get());
 
     return true;
 }
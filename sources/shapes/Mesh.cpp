@@ -0,0 +1,195 @@
+#include "shapes/Mesh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Construct a new Mesh object.
+ *
+ * This function constructs a new Mesh object drawing the triangles of the
+ * given mesh data, scaled uniformly around the origin, with the given
+ * material. The data is shared and is never copied. If the material emits
+ * light, the cumulative areas of the triangles are computed so that the
+ * mesh can be sampled as a light.
+ *
+ * @param data The triangles of the mesh.
+ * @param scale The scale factor of the mesh.
+ * @param material The material of the mesh.
+ *
+ * @return A new Mesh object.
+ */
+Raytracer::Shapes::Mesh::Mesh(std::shared_ptr<const Utils::MeshData> data,
+    double scale, std::shared_ptr<Interfaces::IMaterial> material)
+    : _data(data), _scale(scale), _material(material)
+{
+    Utils::AxisAlignedBBox bbox = _data->boundingBox();
+
+    _bbox = Utils::AxisAlignedBBox(
+        Utils::Interval(bbox.x().min() * _scale, bbox.x().max() * _scale),
+        Utils::Interval(bbox.y().min() * _scale, bbox.y().max() * _scale),
+        Utils::Interval(bbox.z().min() * _scale, bbox.z().max() * _scale));
+
+    if (!emissive()) {
+        return;
+    }
+
+    double total = 0;
+
+    _areas.reserve(_data->triangleCount());
+    for (std::uint32_t i = 0; i < _data->triangleCount(); i++) {
+        Utils::Point3 p0 = _data->vertex(i, 0);
+
+        total += 0.5 * _scale * _scale
+            * cross(_data->vertex(i, 1) - p0, _data->vertex(i, 2) - p0)
+                  .length();
+        _areas.push_back(total);
+    }
+}
+
+/**
+ * @brief Check if the ray hits the mesh.
+ *
+ * This function intersects the ray with the triangles of the mesh through
+ * their BVH. The ray is brought into the space of the mesh data by undoing
+ * the scale, which leaves the distance along the ray unchanged. The normal
+ * is interpolated from the normals of the file when it has some, and the
+ * texture coordinates from its texture coordinates, or are the barycentric
+ * coordinates of the point otherwise.
+ *
+ * @param ray The ray to check for hits.
+ * @param interval The interval to check for hits.
+ * @param payload The payload to update with the hit information.
+ *
+ * @return true if the ray hits the mesh, false otherwise.
+ */
+bool Raytracer::Shapes::Mesh::hit(const Core::Ray &ray,
+    Utils::Interval interval, Core::Payload &payload) const
+{
+    Core::Ray local(
+        ray.origin() / _scale, ray.direction() / _scale, ray.time());
+    Utils::MeshData::Hit hit;
+
+    if (!_data->intersect(local, interval, hit)) {
+        return false;
+    }
+
+    Utils::Point3 p0 = _data->vertex(hit.triangle, 0);
+    Utils::Vec3 geometric =
+        unitVector(cross(_data->vertex(hit.triangle, 1) - p0,
+            _data->vertex(hit.triangle, 2) - p0));
+    std::optional<Utils::Vec3> shading = _data->normal(hit);
+    std::optional<std::pair<double, double>> uv = _data->uv(hit);
+    Utils::Vec3 normal = geometric;
+
+    if (shading) {
+        normal = dot(*shading, geometric) < 0 ? -*shading : *shading;
+    }
+
+    payload.t(hit.t);
+    payload.point(ray.at(hit.t));
+    payload.material(_material.get());
+    payload.setFaceNormal(ray, normal);
+    payload.u(uv ? uv->first : hit.b1);
+    payload.v(uv ? uv->second : hit.b2);
+
+    return true;
+}
+
+/**
+ * @brief Get the bounding box of the mesh.
+ *
+ * This function returns the bounding box of the mesh.
+ *
+ * @return The bounding box of the mesh.
+ */
+Raytracer::Utils::AxisAlignedBBox Raytracer::Shapes::Mesh::boundingBox() const
+{
+    return _bbox;
+}
+
+/**
+ * @brief Check if the mesh is a light that can be sampled.
+ *
+ * This function returns true if the material of the mesh emits light.
+ *
+ * @return true if the mesh is a light, false otherwise.
+ */
+bool Raytracer::Shapes::Mesh::emissive() const
+{
+    return _material && _material->emits();
+}
+
+/**
+ * @brief Probability density of a direction towards the mesh.
+ *
+ * This function returns the probability density, with respect to solid
+ * angle, of `random` generating the given direction from the given origin.
+ * A point uniformly distributed over the area of the mesh has a density of
+ * `distance^2 / (cosine * area)` in solid angle, and since `random` samples
+ * hidden and back-facing triangles too, the densities of every triangle the
+ * direction crosses are summed, not only the one it hits first.
+ *
+ * @param origin The origin of the direction.
+ * @param direction The direction to get the density of.
+ *
+ * @return The probability density, or 0 if the direction misses the mesh.
+ */
+double Raytracer::Shapes::Mesh::pdfValue(
+    const Utils::Point3 &origin, const Utils::Vec3 &direction) const
+{
+    if (_areas.empty()) {
+        return 0;
+    }
+
+    Core::Ray local(origin / _scale, direction / _scale, 0);
+    Utils::MeshData::Hit hit;
+    double infinity = std::numeric_limits<double>::infinity();
+    double lengthSquared = direction.lengthSquared();
+    double length = std::sqrt(lengthSquared);
+    double pdf = 0;
+
+    for (double start = 0.001;
+        _data->intersect(local, Utils::Interval(start, infinity), hit);
+        start = hit.t) {
+        Utils::Point3 p0 = _data->vertex(hit.triangle, 0);
+        Utils::Vec3 normal =
+            unitVector(cross(_data->vertex(hit.triangle, 1) - p0,
+                _data->vertex(hit.triangle, 2) - p0));
+        double cosine = std::fabs(dot(direction, normal)) / length;
+
+        pdf += hit.t * hit.t * lengthSquared / (cosine * _areas.back());
+    }
+
+    return pdf;
+}
+
+/**
+ * @brief Random direction towards the mesh.
+ *
+ * This function picks a triangle with a probability proportional to its
+ * area, then returns the direction from the given origin to a point
+ * uniformly distributed over that triangle.
+ *
+ * @param origin The origin of the direction.
+ *
+ * @return A random direction towards the mesh.
+ */
+Raytracer::Utils::Vec3 Raytracer::Shapes::Mesh::random(
+    const Utils::Point3 &origin) const
+{
+    if (_areas.empty()) {
+        return Utils::Vec3(1, 0, 0);
+    }
+
+    auto it = std::upper_bound(_areas.begin(), _areas.end(),
+        Utils::randomDouble() * _areas.back());
+    std::uint32_t triangle = static_cast<std::uint32_t>(
+        std::min<std::size_t>(it - _areas.begin(), _areas.size() - 1));
+    double r1 = std::sqrt(Utils::randomDouble());
+    double r2 = Utils::randomDouble();
+    Utils::Point3 point = (1 - r1) * _data->vertex(triangle, 0)
+        + r1 * (1 - r2) * _data->vertex(triangle, 1)
+        + r1 * r2 * _data->vertex(triangle, 2);
+
+    return _scale * point - origin;
+}
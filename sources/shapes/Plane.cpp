@@ -5,7 +5,7 @@
  *
  * This function constructs a new Plane object with the given point, normal,
  * and material. The plane is centered at the given point with the given normal
- * and material.
+ * and material. The plane is infinite, so its bounding box is the universe.
  *
  * @param point The point of the plane.
  * @param normal The normal of the plane.
@@ -17,7 +17,7 @@ Raytracer::Shapes::Plane::Plane(const Utils::Point3 &point,
     const Utils::Vec3 &normal, std::shared_ptr<Interfaces::IMaterial> material)
     : _point(point), _normal(normal), _material(material)
 {
-    _bbox = Utils::AxisAlignedBBox(_point, _point);
+    _bbox = Utils::AxisAlignedBBox::Universe;
 }
 
 /**
@@ -50,7 +50,7 @@ bool Raytracer::Shapes::Plane::hit(const Core::Ray &ray,
     Utils::Vec3 intersection = ray.at(t);
     payload.t(t);
     payload.point(intersection);
-    payload.material(_material);
+    payload.material(_material.get());
     payload.setFaceNormal(ray, _normal);
 
     return true;
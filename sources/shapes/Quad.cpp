@@ -1,4 +1,5 @@
 #include "shapes/Quad.hpp"
+#include <limits>
 #include <memory>
 
 /**
@@ -23,6 +24,7 @@ Raytracer::Shapes::Quad::Quad(const Utils::Point3 &Q, const Utils::Vec3 &u,
     _normal = Utils::unitVector(n);
     _D = dot(_normal, _Q);
     _w = n / dot(n, n);
+    _area = n.length();
 
     setBBox();
 }
@@ -65,7 +67,7 @@ bool Raytracer::Shapes::Quad::hit(const Core::Ray &ray,
 
     payload.t(t);
     payload.point(intersection);
-    payload.material(_material);
+    payload.material(_material.get());
     payload.setFaceNormal(ray, _normal);
 
     return true;
@@ -83,6 +85,68 @@ Raytracer::Utils::AxisAlignedBBox Raytracer::Shapes::Quad::boundingBox() const
     return _bbox;
 }
 
+/**
+ * @brief Check if the quad is a light that can be sampled.
+ *
+ * This function returns true if the material of the quad emits light.
+ *
+ * @return true if the quad is a light, false otherwise.
+ */
+bool Raytracer::Shapes::Quad::emissive() const
+{
+    return _material && _material->emits();
+}
+
+/**
+ * @brief Probability density of a direction towards the quad.
+ *
+ * This function returns the probability density, with respect to solid
+ * angle, of `random` generating the given direction from the given origin.
+ * A point uniformly distributed over the area of the quad has a density of
+ * `distance^2 / (cosine * area)` in solid angle.
+ *
+ * @param origin The origin of the direction.
+ * @param direction The direction to get the density of.
+ *
+ * @return The probability density, or 0 if the direction misses the quad.
+ */
+double Raytracer::Shapes::Quad::pdfValue(
+    const Utils::Point3 &origin, const Utils::Vec3 &direction) const
+{
+    Core::Payload payload;
+    double infinity = std::numeric_limits<double>::infinity();
+
+    if (!hit(Core::Ray(origin, direction), Utils::Interval(0.001, infinity),
+            payload)) {
+        return 0;
+    }
+
+    double distanceSquared =
+        payload.t() * payload.t() * direction.lengthSquared();
+    double cosine = std::fabs(dot(direction, _normal) / direction.length());
+
+    return distanceSquared / (cosine * _area);
+}
+
+/**
+ * @brief Random direction towards the quad.
+ *
+ * This function returns the direction from the given origin to a point
+ * uniformly distributed over the area of the quad.
+ *
+ * @param origin The origin of the direction.
+ *
+ * @return A random direction towards the quad.
+ */
+Raytracer::Utils::Vec3 Raytracer::Shapes::Quad::random(
+    const Utils::Point3 &origin) const
+{
+    Utils::Point3 point =
+        _Q + (Utils::randomDouble() * _u) + (Utils::randomDouble() * _v);
+
+    return point - origin;
+}
+
 /**
  * @brief Set the bounding box of the quad.
  *
@@ -1,5 +1,6 @@
 #include "shapes/Sphere.hpp"
 #include <cmath>
+#include <limits>
 
 /**
  * @brief Construct a new Sphere object.
@@ -95,7 +96,7 @@ bool Raytracer::Shapes::Sphere::hit(const Core::Ray &ray,
 
     payload.setFaceNormal(ray, normal);
     getSphereUV(normal, payload.u(), payload.v());
-    payload.material(_material);
+    payload.material(_material.get());
 
     return true;
 }
@@ -113,6 +114,94 @@ Raytracer::Shapes::Sphere::boundingBox() const
     return _bbox;
 }
 
+/**
+ * @brief Check if the sphere is a light that can be sampled.
+ *
+ * This function returns true if the material of the sphere emits light.
+ * Moving spheres are never sampled directly, their position depends on the
+ * time of the ray which is not known when a direction is generated.
+ *
+ * @return true if the sphere is a light, false otherwise.
+ */
+bool Raytracer::Shapes::Sphere::emissive() const
+{
+    return !_isMoving && _material && _material->emits();
+}
+
+/**
+ * @brief Probability density of a direction towards the sphere.
+ *
+ * This function returns the probability density, with respect to solid
+ * angle, of `random` generating the given direction from the given origin.
+ * The directions are uniformly distributed in the cone subtended by the
+ * sphere, or over the whole sphere of directions when the origin is inside.
+ *
+ * @param origin The origin of the direction.
+ * @param direction The direction to get the density of.
+ *
+ * @return The probability density, or 0 if the direction misses the sphere.
+ */
+double Raytracer::Shapes::Sphere::pdfValue(
+    const Utils::Point3 &origin, const Utils::Vec3 &direction) const
+{
+    Core::Payload payload;
+    double infinity = std::numeric_limits<double>::infinity();
+
+    if (!hit(Core::Ray(origin, direction), Utils::Interval(0.001, infinity),
+            payload)) {
+        return 0;
+    }
+
+    double distanceSquared = (_center - origin).lengthSquared();
+
+    if (distanceSquared <= _radius * _radius) {
+        return 1 / (4 * M_PI);
+    }
+
+    double cosThetaMax =
+        std::sqrt(1 - _radius * _radius / distanceSquared);
+
+    return 1 / (2 * M_PI * (1 - cosThetaMax));
+}
+
+/**
+ * @brief Random direction towards the sphere.
+ *
+ * This function returns a direction uniformly distributed in the cone
+ * subtended by the sphere as seen from the given origin.
+ *
+ * @param origin The origin of the direction.
+ *
+ * @return A random direction towards the sphere.
+ */
+Raytracer::Utils::Vec3 Raytracer::Shapes::Sphere::random(
+    const Utils::Point3 &origin) const
+{
+    Utils::Vec3 direction = _center - origin;
+    double distanceSquared = direction.lengthSquared();
+
+    if (distanceSquared <= _radius * _radius) {
+        return Utils::randomUnitVector<double, 3>();
+    }
+
+    double r1 = Utils::randomDouble();
+    double r2 = Utils::randomDouble();
+    double cosThetaMax =
+        std::sqrt(1 - _radius * _radius / distanceSquared);
+    double z = 1 + r2 * (cosThetaMax - 1);
+    double phi = 2 * M_PI * r1;
+    double sinTheta = std::sqrt(1 - z * z);
+
+    Utils::Vec3 w = Utils::unitVector(direction);
+    Utils::Vec3 a =
+        (std::fabs(w.x()) > 0.9) ? Utils::Vec3(0, 1, 0) : Utils::Vec3(1, 0, 0);
+    Utils::Vec3 v = Utils::unitVector(cross(w, a));
+    Utils::Vec3 u = cross(w, v);
+
+    return (std::cos(phi) * sinTheta) * u + (std::sin(phi) * sinTheta) * v
+        + z * w;
+}
+
 /**
  * @brief Get the center of the sphere at the given time.
  *
@@ -0,0 +1,285 @@
+#include "utils/Affine.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Get a translation.
+ *
+ * This function returns the transform moving every point by the given
+ * offset.
+ *
+ * @param offset The offset of the translation.
+ *
+ * @return The translation.
+ */
+Raytracer::Utils::Affine Raytracer::Utils::Affine::translation(
+    const Vec3 &offset)
+{
+    Affine result;
+
+    for (int i = 0; i < 3; i++) {
+        result._m[i][3] = offset[i];
+    }
+
+    return result;
+}
+
+/**
+ * @brief Get a rotation around an axis.
+ *
+ * This function returns the transform rotating every point around the x, y
+ * or z axis by the given angle, counterclockwise when looking down the axis
+ * towards the origin.
+ *
+ * @param axis The axis of the rotation, 0 for x, 1 for y and 2 for z.
+ * @param angle The angle of the rotation, in degrees.
+ *
+ * @return The rotation.
+ */
+Raytracer::Utils::Affine Raytracer::Utils::Affine::rotation(
+    int axis, double angle)
+{
+    Affine result;
+    double radians = degreesToRadians(angle);
+    double sinTheta = std::sin(radians);
+    double cosTheta = std::cos(radians);
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+
+    result._m[u][u] = cosTheta;
+    result._m[u][v] = -sinTheta;
+    result._m[v][u] = sinTheta;
+    result._m[v][v] = cosTheta;
+
+    return result;
+}
+
+/**
+ * @brief Get a scaling.
+ *
+ * This function returns the transform scaling every point around the origin
+ * by the given factor along each axis.
+ *
+ * @param factors The scale factors along the x, y and z axes.
+ *
+ * @return The scaling.
+ */
+Raytracer::Utils::Affine Raytracer::Utils::Affine::scaling(
+    const Vec3 &factors)
+{
+    Affine result;
+
+    for (int i = 0; i < 3; i++) {
+        result._m[i][i] = factors[i];
+    }
+
+    return result;
+}
+
+/**
+ * @brief Compose two transforms.
+ *
+ * This function returns the transform applying the given transform first,
+ * then this one.
+ *
+ * @param other The transform to apply first.
+ *
+ * @return The composed transform.
+ */
+Raytracer::Utils::Affine Raytracer::Utils::Affine::operator*(
+    const Affine &other) const
+{
+    Affine result;
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            result._m[i][j] = j == 3 ? _m[i][3] : 0;
+            for (int k = 0; k < 3; k++) {
+                result._m[i][j] += _m[i][k] * other._m[k][j];
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Get the inverse of the transform.
+ *
+ * This function returns the transform undoing this one, computed from the
+ * adjugate of its linear part. The transform must not be degenerate.
+ *
+ * @return The inverse transform.
+ */
+Raytracer::Utils::Affine Raytracer::Utils::Affine::inverse() const
+{
+    Affine result;
+    double inverseDeterminant = 1.0 / determinant();
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            int i1 = (j + 1) % 3;
+            int i2 = (j + 2) % 3;
+            int j1 = (i + 1) % 3;
+            int j2 = (i + 2) % 3;
+
+            result._m[i][j] = inverseDeterminant
+                * (_m[i1][j1] * _m[i2][j2] - _m[i1][j2] * _m[i2][j1]);
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        result._m[i][3] = 0;
+        for (int k = 0; k < 3; k++) {
+            result._m[i][3] -= result._m[i][k] * _m[k][3];
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Get the determinant of the transform.
+ *
+ * This function returns the determinant of the linear part of the
+ * transform, the factor by which it scales volumes.
+ *
+ * @return The determinant of the transform.
+ */
+double Raytracer::Utils::Affine::determinant() const
+{
+    return _m[0][0] * (_m[1][1] * _m[2][2] - _m[1][2] * _m[2][1])
+        - _m[0][1] * (_m[1][0] * _m[2][2] - _m[1][2] * _m[2][0])
+        + _m[0][2] * (_m[1][0] * _m[2][1] - _m[1][1] * _m[2][0]);
+}
+
+/**
+ * @brief Check if the transform preserves angles.
+ *
+ * This function returns true if the transform is made of rotations,
+ * translations and uniform scalings only, so that it maps solid angles seen
+ * from a point to the same solid angles seen from the transformed point.
+ *
+ * @return true if the transform preserves angles, false otherwise.
+ */
+bool Raytracer::Utils::Affine::similarity() const
+{
+    static constexpr double epsilon = 1e-9;
+    double scale = 0;
+
+    for (int k = 0; k < 3; k++) {
+        scale += _m[k][0] * _m[k][0];
+    }
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = i; j < 3; j++) {
+            double product = 0;
+
+            for (int k = 0; k < 3; k++) {
+                product += _m[k][i] * _m[k][j];
+            }
+            if (std::fabs(product - (i == j ? scale : 0))
+                > epsilon * scale) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Transform a point.
+ *
+ * This function returns the given point moved by the transform.
+ *
+ * @param p The point to transform.
+ *
+ * @return The transformed point.
+ */
+Raytracer::Utils::Point3 Raytracer::Utils::Affine::point(
+    const Point3 &p) const
+{
+    return Point3(
+        _m[0][0] * p[0] + _m[0][1] * p[1] + _m[0][2] * p[2] + _m[0][3],
+        _m[1][0] * p[0] + _m[1][1] * p[1] + _m[1][2] * p[2] + _m[1][3],
+        _m[2][0] * p[0] + _m[2][1] * p[1] + _m[2][2] * p[2] + _m[2][3]);
+}
+
+/**
+ * @brief Transform a vector.
+ *
+ * This function returns the given vector transformed by the linear part of
+ * the transform, which leaves it unaffected by translations.
+ *
+ * @param v The vector to transform.
+ *
+ * @return The transformed vector.
+ */
+Raytracer::Utils::Vec3 Raytracer::Utils::Affine::vector(const Vec3 &v) const
+{
+    return Vec3(_m[0][0] * v[0] + _m[0][1] * v[1] + _m[0][2] * v[2],
+        _m[1][0] * v[0] + _m[1][1] * v[1] + _m[1][2] * v[2],
+        _m[2][0] * v[0] + _m[2][1] * v[1] + _m[2][2] * v[2]);
+}
+
+/**
+ * @brief Transform a vector by the transposed transform.
+ *
+ * This function returns the given vector transformed by the transpose of
+ * the linear part of the transform. Applied to the inverse of a transform,
+ * it maps the normals of a surface to the normals of the transformed
+ * surface.
+ *
+ * @param v The vector to transform.
+ *
+ * @return The transformed vector.
+ */
+Raytracer::Utils::Vec3 Raytracer::Utils::Affine::transposed(
+    const Vec3 &v) const
+{
+    return Vec3(_m[0][0] * v[0] + _m[1][0] * v[1] + _m[2][0] * v[2],
+        _m[0][1] * v[0] + _m[1][1] * v[1] + _m[2][1] * v[2],
+        _m[0][2] * v[0] + _m[1][2] * v[1] + _m[2][2] * v[2]);
+}
+
+/**
+ * @brief Transform a bounding box.
+ *
+ * This function returns the smallest axis-aligned box holding the given box
+ * once transformed, computed from the extent of the box along each axis
+ * rather than from its eight corners. Axes that do not contribute to an
+ * axis of the result are skipped, so that an unbounded box moved by a
+ * translation stays unbounded.
+ *
+ * @param bbox The bounding box to transform.
+ *
+ * @return The transformed bounding box.
+ */
+Raytracer::Utils::AxisAlignedBBox Raytracer::Utils::Affine::box(
+    const AxisAlignedBBox &bbox) const
+{
+    Point3 min;
+    Point3 max;
+
+    for (int i = 0; i < 3; i++) {
+        min[i] = _m[i][3];
+        max[i] = _m[i][3];
+        for (int j = 0; j < 3; j++) {
+            if (_m[i][j] == 0) {
+                continue;
+            }
+
+            double a = _m[i][j] * bbox.axisInterval(j).min();
+            double b = _m[i][j] * bbox.axisInterval(j).max();
+
+            min[i] += std::min(a, b);
+            max[i] += std::max(a, b);
+        }
+    }
+
+    AxisAlignedBBox result(min, max);
+
+    result.padToMinimum();
+
+    return result;
+}
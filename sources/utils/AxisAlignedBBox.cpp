@@ -148,6 +148,40 @@ int Raytracer::Utils::AxisAlignedBBox::longestAxis() const
     }
 }
 
+/**
+ * @brief Get the surface area of the AxisAlignedBBox.
+ *
+ * This function returns the surface area of the AxisAlignedBBox. The surface
+ * area of an empty AxisAlignedBBox is 0.
+ *
+ * @return The surface area of the AxisAlignedBBox.
+ */
+double Raytracer::Utils::AxisAlignedBBox::surfaceArea() const
+{
+    double x = _x.size();
+    double y = _y.size();
+    double z = _z.size();
+
+    if (x < 0 || y < 0 || z < 0) {
+        return 0;
+    }
+
+    return 2 * (x * y + y * z + z * x);
+}
+
+/**
+ * @brief Get the centroid of the AxisAlignedBBox.
+ *
+ * This function returns the point at the center of the AxisAlignedBBox.
+ *
+ * @return The centroid of the AxisAlignedBBox.
+ */
+Raytracer::Utils::Point3 Raytracer::Utils::AxisAlignedBBox::centroid() const
+{
+    return Point3((_x.min() + _x.max()) / 2, (_y.min() + _y.max()) / 2,
+        (_z.min() + _z.max()) / 2);
+}
+
 /**
  * @brief Pad the AxisAlignedBBox to the minimum size.
  *
@@ -0,0 +1,351 @@
+#include "utils/BVH4.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "utils/BVHNode.hpp"
+#include "utils/Counters.hpp"
+
+#if defined(__SSE__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+/**
+ * @brief Construct a new BVH4 object.
+ *
+ * This function collapses the given binary BVH tree into a 4-wide BVH. Each
+ * node stores the bounds of up to four children in structure of arrays form
+ * so that all of them are tested with a single vectorised slab test.
+ *
+ * @param root The root of the BVH tree to collapse.
+ *
+ * @return A new BVH4 object.
+ */
+Raytracer::Utils::BVH4::BVH4(const BVHNode &root) : _bbox(root.boundingBox())
+{
+    flatten(root, 1);
+    _nodes.shrink_to_fit();
+    _primitives.shrink_to_fit();
+}
+
+/**
+ * @brief Check if an object is an interior node of the binary BVH.
+ *
+ * This function returns true if the given object is a BVHNode whose two
+ * children are distinct BVHNodes. Any other object ends up in a leaf.
+ *
+ * @param object The object to check.
+ *
+ * @return true if the object is an interior node, false otherwise.
+ */
+bool Raytracer::Utils::BVH4::interior(
+    const std::shared_ptr<Interfaces::IHittable> &object)
+{
+    std::shared_ptr<BVHNode> node = std::dynamic_pointer_cast<BVHNode>(object);
+
+    return node && node->left() != node->right()
+        && std::dynamic_pointer_cast<BVHNode>(node->left())
+        && std::dynamic_pointer_cast<BVHNode>(node->right());
+}
+
+/**
+ * @brief Collapse a binary BVH subtree.
+ *
+ * This function appends a 4-wide node for the given binary node. The children
+ * of the binary node are expanded, largest surface area first, until there
+ * are four of them or none of them is an interior node. Interior children are
+ * collapsed recursively, the others become leaves holding their primitives.
+ * The bounds are stored as floats rounded outwards so that no hit is lost.
+ *
+ * @param node The node to collapse.
+ * @param depth The depth of the node in the tree.
+ *
+ * @return The index of the collapsed node.
+ */
+std::int32_t Raytracer::Utils::BVH4::flatten(
+    const BVHNode &node, std::size_t depth)
+{
+    std::int32_t index = static_cast<std::int32_t>(_nodes.size());
+    std::vector<std::shared_ptr<Interfaces::IHittable>> children = {
+        node.left()};
+
+    if (node.right() != node.left()) {
+        children.push_back(node.right());
+    }
+
+    while (children.size() < 4) {
+        auto largest = children.end();
+        double area = -1;
+
+        for (auto it = children.begin(); it != children.end(); it++) {
+            double candidate = (*it)->boundingBox().surfaceArea();
+
+            if (interior(*it) && candidate > area) {
+                largest = it;
+                area = candidate;
+            }
+        }
+
+        if (largest == children.end()) {
+            break;
+        }
+
+        std::shared_ptr<BVHNode> expanded =
+            std::dynamic_pointer_cast<BVHNode>(*largest);
+
+        *largest = expanded->left();
+        children.push_back(expanded->right());
+    }
+
+    Node flat = {};
+
+    for (int axis = 0; axis < 3; axis++) {
+        for (int lane = 0; lane < 4; lane++) {
+            flat.min[axis][lane] = std::numeric_limits<float>::infinity();
+            flat.max[axis][lane] = -std::numeric_limits<float>::infinity();
+        }
+    }
+
+    _nodes.push_back(flat);
+    _depth = std::max(_depth, depth);
+
+    for (std::size_t lane = 0; lane < children.size(); lane++) {
+        const std::shared_ptr<Interfaces::IHittable> &child = children[lane];
+        AxisAlignedBBox bbox = child->boundingBox();
+
+        for (int axis = 0; axis < 3; axis++) {
+            const Interval &interval = bbox.axisInterval(axis);
+
+            _nodes[index].min[axis][lane] =
+                std::nextafter(static_cast<float>(interval.min()),
+                    -std::numeric_limits<float>::infinity());
+            _nodes[index].max[axis][lane] =
+                std::nextafter(static_cast<float>(interval.max()),
+                    std::numeric_limits<float>::infinity());
+        }
+
+        _nodes[index].valid |= 1 << lane;
+
+        if (interior(child)) {
+            std::int32_t offset = flatten(
+                *std::dynamic_pointer_cast<BVHNode>(child), depth + 1);
+
+            _nodes[index].child[lane] = offset;
+            continue;
+        }
+
+        std::shared_ptr<BVHNode> leaf =
+            std::dynamic_pointer_cast<BVHNode>(child);
+
+        _nodes[index].child[lane] =
+            -static_cast<std::int32_t>(_primitives.size()) - 1;
+
+        if (leaf) {
+            _primitives.push_back(leaf->left());
+            if (leaf->right() != leaf->left()) {
+                _primitives.push_back(leaf->right());
+            }
+        } else {
+            _primitives.push_back(child);
+        }
+
+        _nodes[index].count[lane] = static_cast<std::uint16_t>(
+            _primitives.size() - (-_nodes[index].child[lane] - 1));
+    }
+
+    return index;
+}
+
+/**
+ * @brief Test the ray against the four child boxes of a node.
+ *
+ * This function performs the slab test against the four child boxes of the
+ * given node at once, using SSE when it is available. The entry distance of
+ * every child is written to `distances`. The lower bounds of the boxes are
+ * measured from `upper` and the upper bounds from `lower`, so that the slabs
+ * never shrink when the origin is not representable as a float.
+ *
+ * @param node The node to test.
+ * @param lower The origin of the ray, rounded down.
+ * @param upper The origin of the ray, rounded up.
+ * @param inverse The inverse of the ray direction.
+ * @param tmin The start of the ray interval.
+ * @param tmax The end of the ray interval.
+ * @param distances The entry distance of each child.
+ *
+ * @return A bit mask of the children hit by the ray.
+ */
+int Raytracer::Utils::BVH4::slab(const Node &node, const float lower[3],
+    const float upper[3], const float inverse[3], float tmin, float tmax,
+    float distances[4])
+{
+#if defined(__SSE__) || defined(_M_X64)
+    __m128 near = _mm_set1_ps(tmin);
+    __m128 far = _mm_set1_ps(tmax);
+
+    for (int axis = 0; axis < 3; axis++) {
+        __m128 down = _mm_set1_ps(lower[axis]);
+        __m128 up = _mm_set1_ps(upper[axis]);
+        __m128 inv = _mm_set1_ps(inverse[axis]);
+        __m128 lo = _mm_load_ps(node.min[axis]);
+        __m128 hi = _mm_load_ps(node.max[axis]);
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(lo, up), inv);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(hi, down), inv);
+
+        near = _mm_max_ps(near, _mm_min_ps(t0, t1));
+        far = _mm_min_ps(far, _mm_max_ps(t0, t1));
+    }
+
+    _mm_storeu_ps(distances, near);
+
+    return _mm_movemask_ps(_mm_cmplt_ps(near, far)) & node.valid;
+#else
+    int mask = 0;
+
+    for (int lane = 0; lane < 4; lane++) {
+        float near = tmin;
+        float far = tmax;
+
+        for (int axis = 0; axis < 3; axis++) {
+            float t0 = (node.min[axis][lane] - upper[axis]) * inverse[axis];
+            float t1 = (node.max[axis][lane] - lower[axis]) * inverse[axis];
+
+            near = std::max(near, std::min(t0, t1));
+            far = std::min(far, std::max(t0, t1));
+        }
+
+        distances[lane] = near;
+        mask |= (near < far) << lane;
+    }
+
+    return mask & node.valid;
+#endif
+}
+
+/**
+ * @brief Check if the ray hits the BVH4.
+ *
+ * This function traverses the 4-wide BVH with an explicit stack. The children
+ * hit by the ray are pushed farthest first so that the nearest one is visited
+ * next, and entries farther than the closest hit found so far are skipped.
+ * The origin of the ray is rounded one float away on each side, like the
+ * bounds of the boxes, so that the float slab test stays conservative.
+ *
+ * @param ray The ray to check for hits.
+ * @param interval The interval to check for hits.
+ * @param payload The payload to update with the hit information.
+ *
+ * @return true if the ray hits the BVH4, false otherwise.
+ */
+bool Raytracer::Utils::BVH4::hit(const Raytracer::Core::Ray &ray,
+    Raytracer::Utils::Interval interval,
+    Raytracer::Core::Payload &payload) const
+{
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    const Point3 &rayOrigin = ray.origin();
+    const Vec3 &direction = ray.direction();
+    float lower[3];
+    float upper[3];
+    float inverse[3];
+
+    for (int axis = 0; axis < 3; axis++) {
+        float origin = static_cast<float>(rayOrigin[axis]);
+
+        lower[axis] =
+            std::nextafter(origin, -std::numeric_limits<float>::infinity());
+        upper[axis] =
+            std::nextafter(origin, std::numeric_limits<float>::infinity());
+        inverse[axis] = static_cast<float>(1.0 / direction[axis]);
+    }
+
+    std::array<Entry, stackSize> fixed;
+    std::vector<Entry> dynamic;
+    Entry *stack = fixed.data();
+
+    if (3 * _depth + 1 > stackSize) {
+        dynamic.resize(3 * _depth + 1);
+        stack = dynamic.data();
+    }
+
+    std::size_t size = 0;
+    bool hitAnything = false;
+
+    stack[size++] = {0, 0, -std::numeric_limits<float>::infinity()};
+
+    while (size > 0) {
+        Entry entry = stack[--size];
+
+        if (entry.t > interval.max()) {
+            continue;
+        }
+
+        if (entry.child < 0) {
+            std::size_t offset = -entry.child - 1;
+
+            for (std::uint16_t i = 0; i < entry.count; i++) {
+                if (_primitives[offset + i]->hit(ray, interval, payload)) {
+                    hitAnything = true;
+                    interval = Interval(interval.min(), payload.t());
+                }
+            }
+            continue;
+        }
+
+        const Node &node = _nodes[entry.child];
+        alignas(16) float distances[4];
+        int mask = slab(node, lower, upper, inverse,
+            static_cast<float>(interval.min()),
+            static_cast<float>(interval.max()), distances);
+
+        Utils::Counters::nodes++;
+
+        std::size_t first = size;
+
+        for (int lane = 0; lane < 4; lane++) {
+            if (!(mask & (1 << lane))) {
+                continue;
+            }
+
+            Entry child = {
+                node.child[lane], node.count[lane], distances[lane]};
+            std::size_t i = size++;
+
+            while (i > first && stack[i - 1].t < child.t) {
+                stack[i] = stack[i - 1];
+                i--;
+            }
+            stack[i] = child;
+        }
+    }
+
+    return hitAnything;
+}
+
+/**
+ * @brief Get the bounding box of the BVH4.
+ *
+ * This function returns the bounding box of the BVH4.
+ *
+ * @return The bounding box of the BVH4.
+ */
+Raytracer::Utils::AxisAlignedBBox Raytracer::Utils::BVH4::boundingBox() const
+{
+    return _bbox;
+}
+
+/**
+ * @brief Get the number of nodes of the BVH4.
+ *
+ * This function returns the number of nodes stored in the node array.
+ *
+ * @return The number of nodes.
+ */
+std::size_t Raytracer::Utils::BVH4::nodeCount() const
+{
+    return _nodes.size();
+}
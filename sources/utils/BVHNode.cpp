@@ -1,6 +1,12 @@
 #include "utils/BVHNode.hpp"
 #include <algorithm>
+#include <functional>
+#include <future>
+#include <limits>
+#include <thread>
+#include <vector>
 #include "core/Scene.hpp"
+#include "utils/Counters.hpp"
 
 /**
  * @brief Construct a new BVHNode object.
@@ -20,6 +26,26 @@ Raytracer::Utils::BVHNode::BVHNode(Raytracer::Core::Scene list)
 {
 }
 
+/**
+ * @brief Construct a new BVHNode object.
+ *
+ * This function constructs a new BVHNode object with the given list of
+ * objects using the surface area heuristic. The settings control the maximum
+ * number of objects stored in a leaf and the number of bins used to evaluate
+ * the candidate splits.
+ *
+ * @param list The list of objects.
+ * @param settings The BVH build settings.
+ *
+ * @return A new BVHNode object.
+ */
+Raytracer::Utils::BVHNode::BVHNode(
+    Raytracer::Core::Scene list, const BVHSettings &settings)
+    : Raytracer::Utils::BVHNode(
+          list.objects(), 0, list.objects().size(), settings)
+{
+}
+
 /**
  * @brief Construct a new BVHNode object.
  *
@@ -41,6 +67,8 @@ Raytracer::Utils::BVHNode::BVHNode(
 {
     int axis = randomInt(0, 2);
 
+    _axis = axis;
+
     auto fn = (axis == 0) ? boxXCompare
         : (axis == 1)     ? boxYCompare
                           : boxZCompare;
@@ -62,7 +90,471 @@ Raytracer::Utils::BVHNode::BVHNode(
             std::make_shared<Raytracer::Utils::BVHNode>(objects, mid, end);
     }
 
+    finish();
+}
+
+/**
+ * @brief Construct a new BVHNode object.
+ *
+ * This function constructs a new BVHNode object with the given list of
+ * objects, start index, and end index using the builder selected in the
+ * settings. With the SAH builder, ranges are split where the estimated cost
+ * of traversing both children is the lowest, and ranges of at most `leafSize`
+ * objects become a leaf when intersecting all of them is cheaper. With the
+ * median builder, ranges are split at the median of their longest axis.
+ * Ranges of at least `parallelThreshold` objects build their left subtree on
+ * another thread while `threads` allows it, splitting the thread budget
+ * between both subtrees.
+ *
+ * @param objects The list of objects.
+ * @param start The start index.
+ * @param end The end index.
+ * @param settings The BVH build settings.
+ *
+ * @return A new BVHNode object.
+ */
+Raytracer::Utils::BVHNode::BVHNode(
+    std::vector<std::shared_ptr<Raytracer::Interfaces::IHittable>> &objects,
+    size_t start, size_t end, const BVHSettings &settings)
+{
+    std::size_t objectSpan = end - start;
+    std::size_t leafSize = std::max(1, settings.leafSize());
+    bool sah = settings.builder() == BVHBuilder::BUILDER_SAH;
+    int threads = std::max(1, settings.threads());
+
+    if (objectSpan == 1) {
+        _left = _right = objects[start];
+    } else if (objectSpan == 2) {
+        _left = objects[start];
+        _right = objects[start + 1];
+    } else {
+        double splitCost = 0;
+        std::size_t mid = sah
+            ? splitSAH(objects, start, end, settings.bins(), threads,
+                  splitCost, _axis)
+            : splitMedian(objects, start, end, _axis, threads);
+
+        if (sah && objectSpan <= leafSize
+            && intersectionCost * objectSpan <= splitCost) {
+            std::shared_ptr<Raytracer::Core::Scene> leaf =
+                std::make_shared<Raytracer::Core::Scene>();
+
+            for (std::size_t i = start; i < end; i++) {
+                leaf->add(objects[i]);
+            }
+
+            _left = _right = leaf;
+        } else if (threads > 1 && objectSpan >= parallelThreshold) {
+            BVHSettings leftSettings = settings;
+            BVHSettings rightSettings = settings;
+
+            leftSettings.threads(threads / 2);
+            rightSettings.threads(threads - threads / 2);
+
+            std::future<std::shared_ptr<BVHNode>> left =
+                std::async(std::launch::async, [&]() {
+                    return std::make_shared<Raytracer::Utils::BVHNode>(
+                        objects, start, mid, leftSettings);
+                });
+
+            _right = std::make_shared<Raytracer::Utils::BVHNode>(
+                objects, mid, end, rightSettings);
+            _left = left.get();
+        } else {
+            _left = std::make_shared<Raytracer::Utils::BVHNode>(
+                objects, start, mid, settings);
+            _right = std::make_shared<Raytracer::Utils::BVHNode>(
+                objects, mid, end, settings);
+        }
+    }
+
+    finish();
+}
+
+/**
+ * @brief Run a function over chunks of a range on several threads.
+ *
+ * This function splits the given range in `chunks` contiguous chunks and
+ * calls the function with the index and bounds of each chunk. The first
+ * chunk runs on the calling thread, the others on their own thread.
+ *
+ * @param start The start index.
+ * @param end The end index.
+ * @param chunks The number of chunks.
+ * @param fn The function to call for each chunk.
+ *
+ * @return void
+ */
+void Raytracer::Utils::BVHNode::parallelFor(size_t start, size_t end,
+    int chunks,
+    const std::function<void(int, std::size_t, std::size_t)> &fn)
+{
+    std::size_t span = end - start;
+    std::vector<std::thread> workers;
+
+    for (int c = 1; c < chunks; c++) {
+        workers.emplace_back(fn, c, start + span * c / chunks,
+            start + span * (c + 1) / chunks);
+    }
+
+    fn(0, start, start + span / chunks);
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Partition the objects at the median of their longest axis.
+ *
+ * This function sorts the objects along the longest axis of their bounds and
+ * returns the middle index. Large ranges are sorted in parallel by sorting
+ * both halves on separate threads and merging them, which gives the same
+ * order as a sequential stable sort.
+ *
+ * @param objects The list of objects.
+ * @param start The start index.
+ * @param end The end index.
+ * @param axis Set to the axis the objects are split along.
+ * @param threads The number of threads available.
+ *
+ * @return The index of the first object of the right partition.
+ */
+size_t Raytracer::Utils::BVHNode::splitMedian(
+    std::vector<std::shared_ptr<Raytracer::Interfaces::IHittable>> &objects,
+    size_t start, size_t end, int &axis, int threads)
+{
+    AxisAlignedBBox bounds = AxisAlignedBBox::Empty;
+
+    for (std::size_t i = start; i < end; i++) {
+        bounds = AxisAlignedBBox(bounds, objects[i]->boundingBox());
+    }
+
+    axis = bounds.longestAxis();
+    std::function<void(std::size_t, std::size_t, int)> sort =
+        [&](std::size_t first, std::size_t last, int available) {
+            auto begin = objects.begin();
+
+            if (available < 2 || last - first < parallelThreshold) {
+                std::stable_sort(begin + first, begin + last,
+                    [axis](const std::shared_ptr<Interfaces::IHittable> &a,
+                        const std::shared_ptr<Interfaces::IHittable> &b) {
+                        return boxCompare(a, b, axis);
+                    });
+                return;
+            }
+
+            std::size_t half = first + (last - first) / 2;
+            std::thread worker(sort, first, half, available / 2);
+
+            sort(half, last, available - available / 2);
+            worker.join();
+            std::inplace_merge(begin + first, begin + half, begin + last,
+                [axis](const std::shared_ptr<Interfaces::IHittable> &a,
+                    const std::shared_ptr<Interfaces::IHittable> &b) {
+                    return boxCompare(a, b, axis);
+                });
+        };
+
+    sort(start, end, threads);
+
+    return start + (end - start) / 2;
+}
+
+/**
+ * @brief Partition the objects using the surface area heuristic.
+ *
+ * This function bins the centroids of the objects along each axis and picks
+ * the bin boundary that minimizes the sum of the surface area of each side
+ * multiplied by its object count. The objects are then partitioned around
+ * that boundary. When no boundary separates the objects, they are split at
+ * the median of the longest axis instead. Large ranges compute the centroid
+ * bounds and the bins on several threads and merge the partial results.
+ *
+ * @param objects The list of objects.
+ * @param start The start index.
+ * @param end The end index.
+ * @param bins The number of bins per axis.
+ * @param threads The number of threads available.
+ * @param cost Set to the expected cost of the split, or to infinity when no
+ * boundary separates the objects.
+ * @param splitAxis Set to the axis the objects are split along.
+ *
+ * @return The index of the first object of the right partition.
+ */
+size_t Raytracer::Utils::BVHNode::splitSAH(
+    std::vector<std::shared_ptr<Raytracer::Interfaces::IHittable>> &objects,
+    size_t start, size_t end, int bins, int threads, double &cost,
+    int &splitAxis)
+{
+    bins = std::max(2, bins);
+
+    int chunks = (end - start) >= parallelThreshold ? std::max(1, threads) : 1;
+    std::vector<AxisAlignedBBox> partial(chunks, AxisAlignedBBox::Empty);
+
+    parallelFor(start, end, chunks,
+        [&](int chunk, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                Point3 centroid = objects[i]->boundingBox().centroid();
+                partial[chunk] = AxisAlignedBBox(
+                    partial[chunk], AxisAlignedBBox(centroid, centroid));
+            }
+        });
+
+    AxisAlignedBBox bounds = AxisAlignedBBox::Empty;
+
+    for (const AxisAlignedBBox &box : partial) {
+        bounds = AxisAlignedBBox(bounds, box);
+    }
+
+    auto binIndex = [&](const Point3 &centroid, int axis) {
+        const Interval &extent = bounds.axisInterval(axis);
+        int index = static_cast<int>(
+            bins * ((centroid[axis] - extent.min()) / extent.size()));
+
+        return std::clamp(index, 0, bins - 1);
+    };
+
+    std::size_t cells = 3 * static_cast<std::size_t>(bins);
+    std::vector<AxisAlignedBBox> chunkBoxes(
+        chunks * cells, AxisAlignedBBox::Empty);
+    std::vector<std::size_t> chunkCounts(chunks * cells, 0);
+
+    parallelFor(start, end, chunks,
+        [&](int chunk, std::size_t first, std::size_t last) {
+            std::size_t base = chunk * cells;
+
+            for (std::size_t i = first; i < last; i++) {
+                AxisAlignedBBox box = objects[i]->boundingBox();
+                Point3 centroid = box.centroid();
+
+                for (int axis = 0; axis < 3; axis++) {
+                    if (bounds.axisInterval(axis).size() <= 0) {
+                        continue;
+                    }
+
+                    std::size_t cell =
+                        base + axis * bins + binIndex(centroid, axis);
+
+                    chunkBoxes[cell] = AxisAlignedBBox(chunkBoxes[cell], box);
+                    chunkCounts[cell]++;
+                }
+            }
+        });
+
+    int bestAxis = -1;
+    int bestBin = 0;
+    double bestCost = std::numeric_limits<double>::infinity();
+    double area = 0;
+    std::vector<AxisAlignedBBox> boxes(bins);
+    std::vector<std::size_t> counts(bins);
+    std::vector<double> rightCosts(bins);
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (bounds.axisInterval(axis).size() <= 0) {
+            continue;
+        }
+
+        std::fill(boxes.begin(), boxes.end(), AxisAlignedBBox::Empty);
+        std::fill(counts.begin(), counts.end(), 0);
+
+        for (int chunk = 0; chunk < chunks; chunk++) {
+            for (int i = 0; i < bins; i++) {
+                std::size_t cell = chunk * cells + axis * bins + i;
+
+                boxes[i] = AxisAlignedBBox(boxes[i], chunkBoxes[cell]);
+                counts[i] += chunkCounts[cell];
+            }
+        }
+
+        AxisAlignedBBox accumulated = AxisAlignedBBox::Empty;
+        std::size_t count = 0;
+
+        for (int i = bins - 1; i > 0; i--) {
+            accumulated = AxisAlignedBBox(accumulated, boxes[i]);
+            count += counts[i];
+            rightCosts[i] = accumulated.surfaceArea() * count;
+        }
+
+        area = AxisAlignedBBox(accumulated, boxes[0]).surfaceArea();
+
+        accumulated = AxisAlignedBBox::Empty;
+        count = 0;
+
+        for (int i = 0; i < bins - 1; i++) {
+            accumulated = AxisAlignedBBox(accumulated, boxes[i]);
+            count += counts[i];
+
+            double candidate =
+                accumulated.surfaceArea() * count + rightCosts[i + 1];
+
+            if (count > 0 && count < end - start && candidate < bestCost) {
+                bestCost = candidate;
+                bestAxis = axis;
+                bestBin = i;
+            }
+        }
+    }
+
+    cost = bestAxis == -1 || area <= 0
+        ? std::numeric_limits<double>::infinity()
+        : traversalCost + intersectionCost * bestCost / area;
+
+    if (bestAxis == -1) {
+        int axis = bounds.longestAxis();
+        std::size_t mid = start + (end - start) / 2;
+
+        std::nth_element(objects.begin() + start, objects.begin() + mid,
+            objects.begin() + end,
+            [axis](const std::shared_ptr<Interfaces::IHittable> &a,
+                const std::shared_ptr<Interfaces::IHittable> &b) {
+                return a->boundingBox().centroid()[axis]
+                    < b->boundingBox().centroid()[axis];
+            });
+
+        splitAxis = axis;
+
+        return mid;
+    }
+
+    splitAxis = bestAxis;
+
+    auto it = std::partition(objects.begin() + start, objects.begin() + end,
+        [&](const std::shared_ptr<Interfaces::IHittable> &object) {
+            return binIndex(object->boundingBox().centroid(), bestAxis)
+                <= bestBin;
+        });
+
+    return it - objects.begin();
+}
+
+/**
+ * @brief Compute the bounding box and the cost of the BVHNode.
+ *
+ * This function computes the bounding box of the BVHNode from its children
+ * and accumulates the surface area heuristic cost of the subtree. The cost is
+ * kept unnormalized so that parents can sum the cost of their children.
+ *
+ * @return void
+ */
+void Raytracer::Utils::BVHNode::finish()
+{
     _bbox = AxisAlignedBBox(_left->boundingBox(), _right->boundingBox());
+
+    double area = _bbox.surfaceArea();
+
+    auto childCost =
+        [area](const std::shared_ptr<Interfaces::IHittable> &child) {
+            if (auto node = std::dynamic_pointer_cast<BVHNode>(child)) {
+                return node->_cost;
+            }
+            if (auto scene = std::dynamic_pointer_cast<Core::Scene>(child)) {
+                return intersectionCost * area * scene->objects().size();
+            }
+            return intersectionCost * area;
+        };
+
+    _cost = traversalCost * area + childCost(_left);
+
+    if (_right != _left) {
+        _cost += childCost(_right);
+    }
+}
+
+/**
+ * @brief Get the surface area heuristic cost of the BVHNode.
+ *
+ * This function returns the expected cost of tracing a ray that hits the
+ * bounding box of the BVHNode, expressed in units of `intersectionCost`.
+ *
+ * @return The surface area heuristic cost of the BVHNode.
+ */
+double Raytracer::Utils::BVHNode::sahCost() const
+{
+    double area = _bbox.surfaceArea();
+
+    return area > 0 ? _cost / area : 0;
+}
+
+/**
+ * @brief Refit the BVHNode to replaced objects.
+ *
+ * This function returns a copy of the subtree with the objects found in the
+ * given map swapped for their replacement, and the bounding boxes and the
+ * cost of the nodes recomputed from the leaves up. The topology of the tree
+ * is kept, so a refit is much cheaper than a rebuild but the tree degrades if
+ * the replacements move far from the objects they replace. Only the nodes
+ * and leaves above a replaced object are copied, the others are shared with
+ * this subtree, which is left untouched since it may still be traversed.
+ *
+ * @param replacements The replacement of every replaced object.
+ *
+ * @return The refitted copy of the subtree, or nullptr if no object of the
+ * subtree is replaced.
+ */
+std::shared_ptr<Raytracer::Utils::BVHNode> Raytracer::Utils::BVHNode::refit(
+    const Replacements &replacements) const
+{
+    auto replace = [&replacements](
+                       std::shared_ptr<Interfaces::IHittable> &child) {
+        auto it = replacements.find(child.get());
+
+        if (it != replacements.end()) {
+            child = it->second;
+            return true;
+        }
+        if (auto node = std::dynamic_pointer_cast<BVHNode>(child)) {
+            std::shared_ptr<BVHNode> refitted = node->refit(replacements);
+
+            if (refitted) {
+                child = refitted;
+            }
+            return refitted != nullptr;
+        }
+
+        auto leaf = std::dynamic_pointer_cast<Core::Scene>(child);
+
+        if (!leaf
+            || std::none_of(leaf->objects().begin(), leaf->objects().end(),
+                [&replacements](const auto &object) {
+                    return replacements.contains(object.get());
+                })) {
+            return false;
+        }
+
+        std::shared_ptr<Core::Scene> rebuilt =
+            std::make_shared<Core::Scene>();
+
+        for (const auto &object : leaf->objects()) {
+            auto found = replacements.find(object.get());
+
+            rebuilt->add(found != replacements.end() ? found->second : object);
+        }
+        child = rebuilt;
+
+        return true;
+    };
+
+    std::shared_ptr<Interfaces::IHittable> left = _left;
+    std::shared_ptr<Interfaces::IHittable> right = _right;
+    bool replaced = replace(left);
+
+    if (_right == _left) {
+        right = left;
+    } else {
+        replaced = replace(right) || replaced;
+    }
+    if (!replaced) {
+        return nullptr;
+    }
+
+    std::shared_ptr<BVHNode> copy = std::make_shared<BVHNode>(*this);
+
+    copy->_left = left;
+    copy->_right = right;
+    copy->finish();
+
+    return copy;
 }
 
 /**
@@ -82,11 +574,18 @@ bool Raytracer::Utils::BVHNode::hit(const Raytracer::Core::Ray &ray,
     Raytracer::Utils::Interval interval,
     Raytracer::Core::Payload &payload) const
 {
+    Utils::Counters::nodes++;
+
     if (!_bbox.hit(ray, interval)) {
         return false;
     }
 
     bool hitLeft = _left->hit(ray, interval, payload);
+
+    if (_right == _left) {
+        return hitLeft;
+    }
+
     bool hitRight = _right->hit(ray,
         Interval(interval.min(), hitLeft ? payload.t() : interval.max()),
         payload);
@@ -1,4 +1,8 @@
 #include "utils/Color.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string>
 #include "utils/Interval.hpp"
 
 /**
@@ -20,28 +24,178 @@ double Raytracer::Utils::linearToGamma(double linear)
 }
 
 /**
- * @brief Write a color to an output stream.
+ * @brief Quantise a linear color component to a byte.
  *
- * This function writes a color to an output stream.
+ * This function gamma corrects the given linear color component, clamps it
+ * to [0, 1) and scales it to an 8-bit value.
+ *
+ * @param linear The linear color component.
+ *
+ * @return The 8-bit value of the component.
+ */
+std::uint8_t Raytracer::Utils::toByte(double linear)
+{
+    static const Interval intensity(0.000, 0.999);
+
+    return static_cast<std::uint8_t>(
+        256 * intensity.clamp(linearToGamma(linear)));
+}
+
+/**
+ * @brief Write a framebuffer as a binary PPM image.
+ *
+ * This function quantises the whole framebuffer in a single pass into a
+ * buffer holding the P6 header followed by the RGB bytes of the pixels, and
+ * writes that buffer to the output stream with a single write.
  *
  * @param out The output stream.
- * @param pixelColor The color.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param framebuffer The colors of the pixels, row by row.
  */
-void Raytracer::Utils::writeColor(std::ostream &out, const Color &pixelColor)
+void Raytracer::Utils::writePPM(std::ostream &out, int width, int height,
+    const std::vector<Color> &framebuffer)
 {
-    double r = pixelColor.x();
-    double g = pixelColor.y();
-    double b = pixelColor.z();
+    std::string header = "P6\n" + std::to_string(width) + ' '
+        + std::to_string(height) + "\n255\n";
+    std::vector<char> buffer(header.size() + 3 * framebuffer.size());
+    char *bytes = buffer.data() + header.size();
 
-    r = linearToGamma(r);
-    g = linearToGamma(g);
-    b = linearToGamma(b);
+    std::copy(header.begin(), header.end(), buffer.begin());
+    for (const Color &pixel : framebuffer) {
+        *bytes++ = static_cast<char>(toByte(pixel.x()));
+        *bytes++ = static_cast<char>(toByte(pixel.y()));
+        *bytes++ = static_cast<char>(toByte(pixel.z()));
+    }
 
-    static const Interval intensity(0.000, 0.999);
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+/**
+ * @brief Write a framebuffer as a PFM image.
+ *
+ * This function writes the linear colors of the framebuffer without any
+ * clamping as a Portable Float Map. The header is followed by the RGB
+ * components of the pixels as 32-bit floats in native byte order, which a
+ * negative scale marks as little endian, and the rows go from the bottom of
+ * the image to the top.
+ *
+ * @param out The output stream.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param framebuffer The colors of the pixels, row by row.
+ */
+void Raytracer::Utils::writePFM(std::ostream &out, int width, int height,
+    const std::vector<Color> &framebuffer)
+{
+    std::string header = "PF\n" + std::to_string(width) + ' '
+        + std::to_string(height) + '\n'
+        + (std::endian::native == std::endian::little ? "-1.0\n" : "1.0\n");
+    std::vector<char> buffer(header.size() + 3 * sizeof(float) * width
+        * static_cast<std::size_t>(height));
+    char *bytes = buffer.data() + header.size();
+
+    std::copy(header.begin(), header.end(), buffer.begin());
+    for (int j = height - 1; j >= 0; j--) {
+        for (int i = 0; i < width; i++) {
+            const Color &pixel = framebuffer[j * width + i];
+            float rgb[3] = {static_cast<float>(pixel.x()),
+                static_cast<float>(pixel.y()), static_cast<float>(pixel.z())};
 
-    int rb = int(256 * intensity.clamp(r));
-    int gb = int(256 * intensity.clamp(g));
-    int ib = int(256 * intensity.clamp(b));
+            std::memcpy(bytes, rgb, sizeof(rgb));
+            bytes += sizeof(rgb);
+        }
+    }
+
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+/**
+ * @brief Write a framebuffer as an OpenEXR image.
+ *
+ * This function writes the linear colors of the framebuffer as a single part
+ * scanline OpenEXR image without compression. The header declares three
+ * 32-bit float channels, which the format stores in alphabetical order, and
+ * is followed by the offset table of the scanlines. Each scanline is stored
+ * as its y coordinate, the size of its data and the B, G and R values of its
+ * pixels. Everything is little endian, as required by the format.
+ *
+ * @param out The output stream.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param framebuffer The colors of the pixels, row by row.
+ */
+void Raytracer::Utils::writeEXR(std::ostream &out, int width, int height,
+    const std::vector<Color> &framebuffer)
+{
+    std::string buffer;
+    auto integer = [&buffer](std::uint64_t value, int size) {
+        for (int i = 0; i < size; i++) {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    };
+    auto real = [&integer](float value) {
+        integer(std::bit_cast<std::uint32_t>(value), 4);
+    };
+    auto attribute = [&buffer, &integer](const std::string &name,
+                         const std::string &type, int size) {
+        buffer.append(name).push_back('\0');
+        buffer.append(type).push_back('\0');
+        integer(size, 4);
+    };
+    std::uint64_t lineSize = 3 * sizeof(float) * width;
+
+    buffer.reserve(
+        512 + height * (2 * sizeof(std::uint32_t) + 8 + lineSize));
+    integer(20000630, 4);
+    integer(2, 4);
+
+    attribute("channels", "chlist", 3 * 18 + 1);
+    for (const char *channel : {"B", "G", "R"}) {
+        buffer.append(channel).push_back('\0');
+        integer(2, 4);
+        integer(0, 4);
+        integer(1, 4);
+        integer(1, 4);
+    }
+    buffer.push_back('\0');
+
+    attribute("compression", "compression", 1);
+    buffer.push_back('\0');
+    for (const char *window : {"dataWindow", "displayWindow"}) {
+        attribute(window, "box2i", 16);
+        integer(0, 4);
+        integer(0, 4);
+        integer(width - 1, 4);
+        integer(height - 1, 4);
+    }
+    attribute("lineOrder", "lineOrder", 1);
+    buffer.push_back('\0');
+    attribute("pixelAspectRatio", "float", 4);
+    real(1.0f);
+    attribute("screenWindowCenter", "v2f", 8);
+    real(0.0f);
+    real(0.0f);
+    attribute("screenWindowWidth", "float", 4);
+    real(1.0f);
+    buffer.push_back('\0');
+
+    std::uint64_t offset =
+        buffer.size() + 8 * static_cast<std::uint64_t>(height);
+
+    for (int j = 0; j < height; j++) {
+        integer(offset + j * (8 + lineSize), 8);
+    }
+
+    for (int j = 0; j < height; j++) {
+        integer(j, 4);
+        integer(lineSize, 4);
+        for (int channel = 2; channel >= 0; channel--) {
+            for (int i = 0; i < width; i++) {
+                real(static_cast<float>(framebuffer[j * width + i][channel]));
+            }
+        }
+    }
 
-    out << rb << ' ' << gb << ' ' << ib << '\n';
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 }
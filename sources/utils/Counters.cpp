@@ -0,0 +1,29 @@
+#include "utils/Counters.hpp"
+#include <cstdint>
+
+/**
+ * @brief The number of rays traced by the current thread.
+ *
+ * This counter is incremented for every ray cast into the scene.
+ */
+thread_local std::uint64_t Raytracer::Utils::Counters::rays = 0;
+
+/**
+ * @brief The number of BVH nodes visited by the current thread.
+ *
+ * This counter is incremented for every BVH node whose bounds are tested.
+ */
+thread_local std::uint64_t Raytracer::Utils::Counters::nodes = 0;
+
+/**
+ * @brief Reset the counters of the current thread.
+ *
+ * This function sets the counters of the calling thread back to zero.
+ *
+ * @return void
+ */
+void Raytracer::Utils::Counters::reset()
+{
+    rays = 0;
+    nodes = 0;
+}
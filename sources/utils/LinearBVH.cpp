@@ -0,0 +1,223 @@
+#include "utils/LinearBVH.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "utils/BVHNode.hpp"
+#include "utils/Counters.hpp"
+
+/**
+ * @brief Construct a new LinearBVH object.
+ *
+ * This function flattens the given BVH tree into a contiguous array of nodes
+ * stored in depth-first order. The first child of an interior node is the
+ * node right after it, the second child is stored at `offset`. Leaves store
+ * the range of their primitives in `offset` and `count`.
+ *
+ * @param root The root of the BVH tree to flatten.
+ *
+ * @return A new LinearBVH object.
+ */
+Raytracer::Utils::LinearBVH::LinearBVH(const BVHNode &root)
+    : _bbox(root.boundingBox())
+{
+    flatten(root, 1);
+    _nodes.shrink_to_fit();
+    _primitives.shrink_to_fit();
+}
+
+/**
+ * @brief Flatten a BVH subtree.
+ *
+ * This function appends the given node and its subtree to the node array. A
+ * node whose children are both BVH nodes becomes an interior node, any other
+ * node becomes a leaf holding its children as primitives. The bounds are
+ * stored as floats rounded outwards so that no hit is lost.
+ *
+ * @param node The node to flatten.
+ * @param depth The depth of the node in the tree.
+ *
+ * @return The index of the flattened node.
+ */
+std::int32_t Raytracer::Utils::LinearBVH::flatten(
+    const BVHNode &node, std::size_t depth)
+{
+    std::int32_t index = static_cast<std::int32_t>(_nodes.size());
+    AxisAlignedBBox bbox = node.boundingBox();
+    Node flat = {};
+
+    for (int axis = 0; axis < 3; axis++) {
+        const Interval &interval = bbox.axisInterval(axis);
+
+        flat.min[axis] =
+            std::nextafter(static_cast<float>(interval.min()),
+                -std::numeric_limits<float>::infinity());
+        flat.max[axis] =
+            std::nextafter(static_cast<float>(interval.max()),
+                std::numeric_limits<float>::infinity());
+    }
+
+    _nodes.push_back(flat);
+    _depth = std::max(_depth, depth);
+
+    std::shared_ptr<BVHNode> left =
+        std::dynamic_pointer_cast<BVHNode>(node.left());
+    std::shared_ptr<BVHNode> right =
+        std::dynamic_pointer_cast<BVHNode>(node.right());
+
+    if (left && right && left != right) {
+        flatten(*left, depth + 1);
+        std::int32_t second = flatten(*right, depth + 1);
+
+        _nodes[index].offset = second;
+        _nodes[index].axis = static_cast<std::uint8_t>(node.axis());
+    } else {
+        _nodes[index].offset =
+            static_cast<std::int32_t>(_primitives.size());
+        _nodes[index].count = node.left() == node.right() ? 1 : 2;
+        _primitives.push_back(node.left());
+        if (node.right() != node.left()) {
+            _primitives.push_back(node.right());
+        }
+    }
+
+    return index;
+}
+
+/**
+ * @brief Check if the ray hits the bounds of a node.
+ *
+ * This function performs the slab test against the float bounds of the given
+ * node using the precomputed inverse of the ray direction.
+ *
+ * @param node The node to test.
+ * @param origin The origin of the ray.
+ * @param inverse The inverse of the ray direction.
+ * @param interval The interval to check for hits.
+ *
+ * @return true if the ray hits the node, false otherwise.
+ */
+bool Raytracer::Utils::LinearBVH::slab(const Node &node, const Point3 &origin,
+    const Vec3 &inverse, const Interval &interval)
+{
+    double tmin = interval.min();
+    double tmax = interval.max();
+
+    for (int axis = 0; axis < 3; axis++) {
+        double t0 = (node.min[axis] - origin[axis]) * inverse[axis];
+        double t1 = (node.max[axis] - origin[axis]) * inverse[axis];
+
+        if (inverse[axis] < 0) {
+            std::swap(t0, t1);
+        }
+
+        tmin = t0 > tmin ? t0 : tmin;
+        tmax = t1 < tmax ? t1 : tmax;
+
+        if (tmax <= tmin) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check if the ray hits the LinearBVH.
+ *
+ * This function traverses the node array with an explicit stack. At interior
+ * nodes the child closest to the ray origin along the node axis is visited
+ * first, and the interval is shrunk after every hit so that farther nodes
+ * are culled.
+ *
+ * @param ray The ray to check for hits.
+ * @param interval The interval to check for hits.
+ * @param payload The payload to update with the hit information.
+ *
+ * @return true if the ray hits the LinearBVH, false otherwise.
+ */
+bool Raytracer::Utils::LinearBVH::hit(const Raytracer::Core::Ray &ray,
+    Raytracer::Utils::Interval interval,
+    Raytracer::Core::Payload &payload) const
+{
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    const Point3 &origin = ray.origin();
+    const Vec3 &direction = ray.direction();
+    Vec3 inverse(1.0 / direction[0], 1.0 / direction[1], 1.0 / direction[2]);
+
+    std::array<std::int32_t, stackSize> fixed;
+    std::vector<std::int32_t> dynamic;
+    std::int32_t *stack = fixed.data();
+
+    if (_depth > stackSize) {
+        dynamic.resize(_depth);
+        stack = dynamic.data();
+    }
+
+    std::size_t size = 0;
+    std::int32_t current = 0;
+    bool hitAnything = false;
+
+    while (true) {
+        const Node &node = _nodes[current];
+
+        Utils::Counters::nodes++;
+
+        if (slab(node, origin, inverse, interval)) {
+            if (node.count > 0) {
+                for (std::uint16_t i = 0; i < node.count; i++) {
+                    if (_primitives[node.offset + i]->hit(
+                            ray, interval, payload)) {
+                        hitAnything = true;
+                        interval = Interval(interval.min(), payload.t());
+                    }
+                }
+            } else if (inverse[node.axis] < 0) {
+                stack[size++] = current + 1;
+                current = node.offset;
+                continue;
+            } else {
+                stack[size++] = node.offset;
+                current = current + 1;
+                continue;
+            }
+        }
+
+        if (size == 0) {
+            break;
+        }
+        current = stack[--size];
+    }
+
+    return hitAnything;
+}
+
+/**
+ * @brief Get the bounding box of the LinearBVH.
+ *
+ * This function returns the bounding box of the LinearBVH.
+ *
+ * @return The bounding box of the LinearBVH.
+ */
+Raytracer::Utils::AxisAlignedBBox
+Raytracer::Utils::LinearBVH::boundingBox() const
+{
+    return _bbox;
+}
+
+/**
+ * @brief Get the number of nodes of the LinearBVH.
+ *
+ * This function returns the number of nodes stored in the node array.
+ *
+ * @return The number of nodes.
+ */
+std::size_t Raytracer::Utils::LinearBVH::nodeCount() const
+{
+    return _nodes.size();
+}
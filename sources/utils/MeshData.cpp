@@ -0,0 +1,1072 @@
+#include "utils/MeshData.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <fcntl.h>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include "exceptions/File.hpp"
+#include "utils/Counters.hpp"
+
+std::string Raytracer::Utils::MeshData::_cacheDirectory;
+
+/**
+ * @brief Load a mesh from an OBJ file.
+ *
+ * This function maps the given Wavefront OBJ file in memory, parses its
+ * vertices, normals, texture coordinates and faces into the buffers of a new
+ * mesh and builds the BVH of its triangles. A mesh is loaded once and shared
+ * by every shape using the same file, as long as the file is not modified.
+ * When a cache directory is set, the buffers and the BVH are used in place
+ * from the cache file named after the hash of the content of the OBJ file
+ * instead, and are written to it after they are built when it does not exist
+ * yet or does not hold a valid mesh.
+ *
+ * @param path The path of the OBJ file.
+ * @throw Exceptions::FileException if the file cannot be read or parsed.
+ *
+ * @return The loaded mesh.
+ */
+std::shared_ptr<const Raytracer::Utils::MeshData>
+Raytracer::Utils::MeshData::load(const std::string &path)
+{
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<const MeshData>>
+        cache;
+
+    std::error_code error;
+    std::string key = std::filesystem::weakly_canonical(path, error).string()
+        + std::format(":{}",
+            std::filesystem::last_write_time(path, error)
+                .time_since_epoch()
+                .count());
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (std::shared_ptr<const MeshData> cached = cache[key].lock()) {
+        return cached;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat info = {};
+
+    if (fd < 0 || fstat(fd, &info) < 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        throw Exceptions::FileException(
+            std::format("could not open mesh `{}`", path));
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        throw Exceptions::FileException(
+            std::format("mesh `{}` is empty", path));
+    }
+
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw Exceptions::FileException(
+            std::format("could not map mesh `{}`", path));
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    std::shared_ptr<MeshData> mesh = std::make_shared<MeshData>();
+    const char *begin = static_cast<const char *>(mapped);
+    std::uint64_t hash = std::hash<std::string_view>()(
+        std::string_view(begin, size));
+    std::string cachePath = _cacheDirectory.empty()
+        ? ""
+        : (std::filesystem::path(_cacheDirectory)
+              / std::format("{:016x}.mesh", hash))
+              .string();
+
+    if (!cachePath.empty() && mesh->readCache(cachePath, hash)) {
+        munmap(mapped, size);
+        cache[key] = mesh;
+        return mesh;
+    }
+
+    std::shared_ptr<Buffers> buffers = std::make_shared<Buffers>();
+
+    try {
+        parse(path, begin, begin + size, *buffers);
+    } catch (...) {
+        munmap(mapped, size);
+        throw;
+    }
+    munmap(mapped, size);
+
+    if (buffers->indices.empty()) {
+        throw Exceptions::FileException(
+            std::format("mesh `{}` has no face", path));
+    }
+
+    mesh->build(*buffers);
+    mesh->use(buffers);
+    if (!cachePath.empty()) {
+        mesh->writeCache(cachePath, hash);
+    }
+    cache[key] = mesh;
+
+    return mesh;
+}
+
+/**
+ * @brief Set the directory of the mesh cache.
+ *
+ * This function sets the directory where the buffers and the BVH of the
+ * loaded meshes are cached, so that loading the same OBJ file again skips
+ * parsing it and building its BVH. An empty path disables the cache.
+ *
+ * @param path The path of the cache directory.
+ *
+ * @return void
+ */
+void Raytracer::Utils::MeshData::cacheDirectory(const std::string &path)
+{
+    _cacheDirectory = path;
+}
+
+/**
+ * @brief Get the directory of the mesh cache.
+ *
+ * This function returns the directory where the loaded meshes are cached.
+ *
+ * @return The path of the cache directory, empty if the cache is disabled.
+ */
+const std::string &Raytracer::Utils::MeshData::cacheDirectory()
+{
+    return _cacheDirectory;
+}
+
+/**
+ * @brief Parse the content of an OBJ file.
+ *
+ * This function reads the `v`, `vn`, `vt` and `f` statements of the given
+ * text and ignores every other statement. The coordinates are stored as
+ * separate arrays per component, and polygons are split into a fan of
+ * triangles. Face indices may be negative, relative to the end of the
+ * vertices read so far, and may omit the normal or texture coordinates.
+ *
+ * @param path The path of the file, for error messages.
+ * @param begin The start of the text.
+ * @param end The end of the text.
+ * @param buffers The buffers receiving the content.
+ * @throw Exceptions::FileException if a statement is malformed.
+ *
+ * @return void
+ */
+void Raytracer::Utils::MeshData::parse(const std::string &path,
+    const char *begin, const char *end, Buffers &buffers)
+{
+    const char *p = begin;
+    std::size_t line = 1;
+
+    auto fail = [&path, &line]() {
+        return Exceptions::FileException(
+            std::format("invalid statement in mesh `{}` at line {}", path,
+                line));
+    };
+    auto blank = [&p, end]() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            p++;
+        }
+    };
+    auto number = [&](float &value) {
+        blank();
+        if (p < end && *p == '+') {
+            p++;
+        }
+
+        std::from_chars_result result = std::from_chars(p, end, value);
+
+        if (result.ec != std::errc()) {
+            throw fail();
+        }
+        p = result.ptr;
+    };
+    auto index = [&](std::size_t count) {
+        long value = 0;
+        std::from_chars_result result = std::from_chars(p, end, value);
+
+        if (result.ec != std::errc()) {
+            throw fail();
+        }
+        p = result.ptr;
+        if (value < 0) {
+            value += static_cast<long>(count);
+        } else {
+            value--;
+        }
+        if (value < 0 || static_cast<std::size_t>(value) >= count) {
+            throw fail();
+        }
+
+        return static_cast<std::uint32_t>(value);
+    };
+
+    std::vector<std::array<std::uint32_t, 3>> polygon;
+
+    while (p < end) {
+        blank();
+
+        if (p + 1 < end && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            float x = 0;
+            float y = 0;
+            float z = 0;
+
+            p++;
+            number(x);
+            number(y);
+            number(z);
+            buffers.x.push_back(x);
+            buffers.y.push_back(y);
+            buffers.z.push_back(z);
+        } else if (p + 2 < end && p[0] == 'v' && p[1] == 'n') {
+            float x = 0;
+            float y = 0;
+            float z = 0;
+
+            p += 2;
+            number(x);
+            number(y);
+            number(z);
+            buffers.nx.push_back(x);
+            buffers.ny.push_back(y);
+            buffers.nz.push_back(z);
+        } else if (p + 2 < end && p[0] == 'v' && p[1] == 't') {
+            float u = 0;
+            float v = 0;
+
+            p += 2;
+            number(u);
+            number(v);
+            buffers.tu.push_back(u);
+            buffers.tv.push_back(v);
+        } else if (p + 1 < end && p[0] == 'f'
+            && (p[1] == ' ' || p[1] == '\t')) {
+            p++;
+            polygon.clear();
+            while (true) {
+                blank();
+                if (p >= end || *p == '\n' || *p == '#') {
+                    break;
+                }
+
+                std::array<std::uint32_t, 3> corner = {
+                    index(buffers.x.size()), none, none};
+
+                if (p < end && *p == '/') {
+                    p++;
+                    if (p < end && *p != '/') {
+                        corner[2] = index(buffers.tu.size());
+                    }
+                    if (p < end && *p == '/') {
+                        p++;
+                        corner[1] = index(buffers.nx.size());
+                    }
+                }
+                polygon.push_back(corner);
+            }
+            if (polygon.size() < 3) {
+                throw fail();
+            }
+            for (std::size_t i = 1; i + 1 < polygon.size(); i++) {
+                for (std::size_t c : {std::size_t(0), i, i + 1}) {
+                    buffers.indices.push_back(polygon[c][0]);
+                    buffers.normalIndices.push_back(polygon[c][1]);
+                    buffers.uvIndices.push_back(polygon[c][2]);
+                }
+            }
+        }
+
+        while (p < end && *p != '\n') {
+            p++;
+        }
+        p++;
+        line++;
+    }
+
+    if (std::all_of(buffers.normalIndices.begin(),
+            buffers.normalIndices.end(),
+            [](std::uint32_t i) { return i == none; })) {
+        buffers.normalIndices.clear();
+    }
+    if (std::all_of(buffers.uvIndices.begin(), buffers.uvIndices.end(),
+            [](std::uint32_t i) { return i == none; })) {
+        buffers.uvIndices.clear();
+    }
+}
+
+/**
+ * @brief Build the BVH of the triangles.
+ *
+ * This function builds a BVH over the triangles of the given buffers with the
+ * binned surface area heuristic, stored as a flat array of nodes like
+ * `LinearBVH`, then reorders the triangles so that every leaf refers to a
+ * contiguous range of them.
+ *
+ * @param buffers The buffers of the mesh.
+ *
+ * @return void
+ */
+void Raytracer::Utils::MeshData::build(Buffers &buffers)
+{
+    std::vector<std::uint32_t> &indices = buffers.indices;
+    std::size_t count = indices.size() / 3;
+    std::vector<Bounds> bounds(count);
+    std::vector<std::uint32_t> order(count);
+
+    for (std::uint32_t i = 0; i < count; i++) {
+        Bounds &box = bounds[i];
+
+        for (int axis = 0; axis < 3; axis++) {
+            const std::vector<float> &values =
+                axis == 0 ? buffers.x : (axis == 1 ? buffers.y : buffers.z);
+
+            box.min[axis] = std::min({values[indices[3 * i]],
+                values[indices[3 * i + 1]], values[indices[3 * i + 2]]});
+            box.max[axis] = std::max({values[indices[3 * i]],
+                values[indices[3 * i + 1]], values[indices[3 * i + 2]]});
+        }
+        order[i] = i;
+    }
+
+    buffers.nodes.reserve(2 * count / leafSize + 1);
+    build(buffers.nodes, order, bounds, 0, count, 1);
+    buffers.nodes.shrink_to_fit();
+
+    const Node &root = buffers.nodes.front();
+
+    _bbox = AxisAlignedBBox(Point3(root.min[0], root.min[1], root.min[2]),
+        Point3(root.max[0], root.max[1], root.max[2]));
+    _bbox.padToMinimum();
+
+    for (std::vector<std::uint32_t> *buffer :
+        {&buffers.indices, &buffers.normalIndices, &buffers.uvIndices}) {
+        if (buffer->empty()) {
+            continue;
+        }
+
+        std::vector<std::uint32_t> sorted(buffer->size());
+
+        for (std::size_t i = 0; i < count; i++) {
+            std::copy_n(buffer->begin() + 3 * order[i], 3,
+                sorted.begin() + 3 * i);
+        }
+        *buffer = std::move(sorted);
+    }
+
+    buffers.x.shrink_to_fit();
+    buffers.y.shrink_to_fit();
+    buffers.z.shrink_to_fit();
+    buffers.indices.shrink_to_fit();
+    buffers.normalIndices.shrink_to_fit();
+    buffers.uvIndices.shrink_to_fit();
+}
+
+/**
+ * @brief Use the given buffers as the content of the mesh.
+ *
+ * This function points the views of the mesh at the given buffers, which are
+ * kept alive as long as the mesh.
+ *
+ * @param buffers The buffers of the mesh.
+ *
+ * @return void
+ */
+void Raytracer::Utils::MeshData::use(
+    const std::shared_ptr<const Buffers> &buffers)
+{
+    _storage = buffers;
+    _x = buffers->x;
+    _y = buffers->y;
+    _z = buffers->z;
+    _nx = buffers->nx;
+    _ny = buffers->ny;
+    _nz = buffers->nz;
+    _tu = buffers->tu;
+    _tv = buffers->tv;
+    _indices = buffers->indices;
+    _normalIndices = buffers->normalIndices;
+    _uvIndices = buffers->uvIndices;
+    _nodes = buffers->nodes;
+}
+
+/**
+ * @brief Build a BVH subtree.
+ *
+ * This function appends the node of the given range of triangles and its
+ * subtree to the given node array. Ranges of at most `leafSize` triangles
+ * become a leaf. Larger ranges are split along the axis and at the bin
+ * boundary that minimize the surface area heuristic, or at their median if the
+ * centroids of their triangles cannot be told apart.
+ *
+ * @param nodes The node array.
+ * @param order The triangles, reordered by the build.
+ * @param bounds The bounding box of every triangle.
+ * @param start The start of the range.
+ * @param end The end of the range.
+ * @param depth The depth of the node in the tree.
+ *
+ * @return The index of the node.
+ */
+std::int32_t Raytracer::Utils::MeshData::build(std::vector<Node> &nodes,
+    std::vector<std::uint32_t> &order, const std::vector<Bounds> &bounds,
+    std::size_t start, std::size_t end, std::size_t depth)
+{
+    std::int32_t index = static_cast<std::int32_t>(nodes.size());
+    float infinity = std::numeric_limits<float>::infinity();
+    Node node = {{infinity, infinity, infinity},
+        {-infinity, -infinity, -infinity}, 0, 0, 0, 0};
+    float low[3] = {infinity, infinity, infinity};
+    float high[3] = {-infinity, -infinity, -infinity};
+
+    for (std::size_t i = start; i < end; i++) {
+        const Bounds &box = bounds[order[i]];
+
+        for (int axis = 0; axis < 3; axis++) {
+            float centroid = 0.5f * (box.min[axis] + box.max[axis]);
+
+            node.min[axis] = std::min(node.min[axis], box.min[axis]);
+            node.max[axis] = std::max(node.max[axis], box.max[axis]);
+            low[axis] = std::min(low[axis], centroid);
+            high[axis] = std::max(high[axis], centroid);
+        }
+    }
+
+    nodes.push_back(node);
+    _depth = std::max(_depth, depth);
+
+    std::size_t count = end - start;
+
+    if (count <= leafSize) {
+        nodes[index].offset = static_cast<std::int32_t>(start);
+        nodes[index].count = static_cast<std::uint16_t>(count);
+        return index;
+    }
+
+    int bestAxis = -1;
+    int bestBin = 0;
+    double bestCost = std::numeric_limits<double>::infinity();
+
+    auto binIndex = [&](const Bounds &box, int axis) {
+        float centroid = 0.5f * (box.min[axis] + box.max[axis]);
+        int bin = static_cast<int>(
+            bins * (centroid - low[axis]) / (high[axis] - low[axis]));
+
+        return std::clamp(bin, 0, bins - 1);
+    };
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (high[axis] <= low[axis]) {
+            continue;
+        }
+
+        std::array<Bounds, bins> boxes;
+        std::array<std::size_t, bins> counts = {};
+
+        for (Bounds &box : boxes) {
+            box = {{infinity, infinity, infinity},
+                {-infinity, -infinity, -infinity}};
+        }
+        for (std::size_t i = start; i < end; i++) {
+            const Bounds &box = bounds[order[i]];
+            int bin = binIndex(box, axis);
+
+            counts[bin]++;
+            for (int a = 0; a < 3; a++) {
+                boxes[bin].min[a] = std::min(boxes[bin].min[a], box.min[a]);
+                boxes[bin].max[a] = std::max(boxes[bin].max[a], box.max[a]);
+            }
+        }
+
+        std::array<double, bins> leftCost = {};
+        Bounds sweep = boxes[0];
+        std::size_t sweepCount = 0;
+
+        for (int bin = 0; bin < bins - 1; bin++) {
+            sweepCount += counts[bin];
+            for (int a = 0; a < 3; a++) {
+                sweep.min[a] = std::min(sweep.min[a], boxes[bin].min[a]);
+                sweep.max[a] = std::max(sweep.max[a], boxes[bin].max[a]);
+            }
+            leftCost[bin] =
+                sweepCount ? area(sweep.min, sweep.max) * sweepCount : 0;
+        }
+
+        sweep = boxes[bins - 1];
+        sweepCount = 0;
+        for (int bin = bins - 1; bin > 0; bin--) {
+            sweepCount += counts[bin];
+            for (int a = 0; a < 3; a++) {
+                sweep.min[a] = std::min(sweep.min[a], boxes[bin].min[a]);
+                sweep.max[a] = std::max(sweep.max[a], boxes[bin].max[a]);
+            }
+
+            double cost = leftCost[bin - 1]
+                + (sweepCount ? area(sweep.min, sweep.max) * sweepCount : 0);
+
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = bin - 1;
+            }
+        }
+    }
+
+    std::size_t mid = start + count / 2;
+
+    if (bestAxis >= 0) {
+        auto it = std::partition(order.begin() + start, order.begin() + end,
+            [&](std::uint32_t triangle) {
+                return binIndex(bounds[triangle], bestAxis) <= bestBin;
+            });
+
+        mid = it - order.begin();
+    }
+    if (mid == start || mid == end) {
+        int axis = bestAxis >= 0 ? bestAxis : 0;
+
+        mid = start + count / 2;
+        std::nth_element(order.begin() + start, order.begin() + mid,
+            order.begin() + end, [&](std::uint32_t a, std::uint32_t b) {
+                return bounds[a].min[axis] + bounds[a].max[axis]
+                    < bounds[b].min[axis] + bounds[b].max[axis];
+            });
+    }
+
+    build(nodes, order, bounds, start, mid, depth + 1);
+
+    std::int32_t second = build(nodes, order, bounds, mid, end, depth + 1);
+
+    nodes[index].offset = second;
+    nodes[index].axis =
+        static_cast<std::uint8_t>(bestAxis >= 0 ? bestAxis : 0);
+
+    return index;
+}
+
+/**
+ * @brief Read the mesh from a cache file.
+ *
+ * This function maps the given cache file in memory and points the buffers
+ * and BVH nodes of the mesh at it, keeping it mapped as long as the mesh. The
+ * file starts with a header holding its format version, the hash of the OBJ
+ * file it was built from and the size of every buffer, followed by the
+ * buffers themselves. A missing file, one whose header does not match or one
+ * whose indices or nodes are out of bounds leaves the mesh untouched.
+ *
+ * @param path The path of the cache file.
+ * @param hash The hash of the content of the OBJ file.
+ *
+ * @return true if the mesh was read from the file, false otherwise.
+ */
+bool Raytracer::Utils::MeshData::readCache(
+    const std::string &path, std::uint64_t hash)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat info = {};
+
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &info) < 0
+        || static_cast<std::size_t>(info.st_size) < sizeof(CacheHeader)) {
+        close(fd);
+        return false;
+    }
+
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    std::shared_ptr<const void> mapping(mapped,
+        [size](const void *pointer) {
+            munmap(const_cast<void *>(pointer), size);
+        });
+    const char *data = static_cast<const char *>(mapped);
+    CacheHeader header;
+
+    std::copy_n(data, sizeof(header), reinterpret_cast<char *>(&header));
+
+    for (std::uint64_t count : {header.vertices, header.normals, header.uvs,
+             header.triangles, header.normalIndices, header.uvIndices,
+             header.nodes}) {
+        if (count > size) {
+            return false;
+        }
+    }
+
+    std::size_t expected = sizeof(header)
+        + sizeof(float)
+            * (3 * header.vertices + 3 * header.normals + 2 * header.uvs)
+        + sizeof(std::uint32_t)
+            * (header.triangles + header.normalIndices + header.uvIndices)
+        + sizeof(Node) * header.nodes;
+
+    if (std::string_view(header.magic, sizeof(header.magic))
+            != std::string_view("RTMESH\0\0", sizeof(header.magic))
+        || header.version != cacheVersion || header.hash != hash
+        || header.nodes == 0 || expected != size) {
+        return false;
+    }
+
+    MeshData cached;
+    const char *cursor = data + sizeof(header);
+    auto view = [&cursor](auto &buffer, std::size_t count) {
+        using Element = typename std::remove_reference_t<
+            decltype(buffer)>::element_type;
+
+        buffer = {reinterpret_cast<Element *>(cursor), count};
+        cursor += count * sizeof(Element);
+    };
+
+    view(cached._x, header.vertices);
+    view(cached._y, header.vertices);
+    view(cached._z, header.vertices);
+    view(cached._nx, header.normals);
+    view(cached._ny, header.normals);
+    view(cached._nz, header.normals);
+    view(cached._tu, header.uvs);
+    view(cached._tv, header.uvs);
+    view(cached._indices, header.triangles);
+    view(cached._normalIndices, header.normalIndices);
+    view(cached._uvIndices, header.uvIndices);
+    view(cached._nodes, header.nodes);
+    if (!cached.validate(header.depth)) {
+        return false;
+    }
+
+    const Node &root = cached._nodes.front();
+
+    cached._storage = std::move(mapping);
+    cached._depth = header.depth;
+    cached._bbox = AxisAlignedBBox(
+        Point3(root.min[0], root.min[1], root.min[2]),
+        Point3(root.max[0], root.max[1], root.max[2]));
+    cached._bbox.padToMinimum();
+    *this = std::move(cached);
+
+    return true;
+}
+
+/**
+ * @brief Check that the buffers of the mesh are consistent.
+ *
+ * This function checks that every vertex, normal and texture coordinate
+ * index of the triangles is within its buffer, that every leaf of the BVH
+ * refers to existing triangles and that every interior node refers to
+ * children stored after it, so that a traversal ends and never needs a
+ * deeper stack than the given depth. It is used on cache files, which may
+ * be truncated or corrupt.
+ *
+ * @param depth The depth of the BVH stored with the nodes.
+ *
+ * @return true if the buffers are consistent, false otherwise.
+ */
+bool Raytracer::Utils::MeshData::validate(std::size_t depth) const
+{
+    std::size_t triangles = triangleCount();
+    auto within = [](std::span<const std::uint32_t> indices,
+                      std::size_t count, bool optional) {
+        return std::all_of(indices.begin(), indices.end(),
+            [count, optional](std::uint32_t index) {
+                return index < count || (optional && index == none);
+            });
+    };
+
+    if (_indices.empty() || _indices.size() % 3 != 0
+        || (!_normalIndices.empty()
+            && _normalIndices.size() != _indices.size())
+        || (!_uvIndices.empty() && _uvIndices.size() != _indices.size())
+        || !within(_indices, _x.size(), false)
+        || !within(_normalIndices, _nx.size(), true)
+        || !within(_uvIndices, _tu.size(), true)) {
+        return false;
+    }
+
+    std::vector<std::size_t> levels(_nodes.size(), 0);
+    std::size_t deepest = 1;
+
+    levels[0] = 1;
+    for (std::size_t i = 0; i < _nodes.size(); i++) {
+        const Node &node = _nodes[i];
+
+        if (node.count > 0) {
+            if (node.offset < 0
+                || static_cast<std::size_t>(node.offset) + node.count
+                    > triangles) {
+                return false;
+            }
+            continue;
+        }
+
+        std::size_t second = static_cast<std::size_t>(node.offset);
+
+        if (node.offset <= 0 || second <= i || second >= _nodes.size()
+            || i + 1 >= _nodes.size() || node.axis > 2) {
+            return false;
+        }
+        for (std::size_t child : {i + 1, second}) {
+            levels[child] = std::max(levels[child], levels[i] + 1);
+            deepest = std::max(deepest, levels[child]);
+        }
+    }
+
+    return deepest == depth;
+}
+
+/**
+ * @brief Write the mesh to a cache file.
+ *
+ * This function writes the buffers and the BVH nodes of the mesh to the
+ * given cache file, in the layout read by `readCache`. The file is written
+ * next to its final path and renamed once complete, so that a render
+ * reading the cache never sees a partial file. A failure is reported but
+ * does not prevent the render.
+ *
+ * @param path The path of the cache file.
+ * @param hash The hash of the content of the OBJ file.
+ *
+ * @return void
+ */
+void Raytracer::Utils::MeshData::writeCache(
+    const std::string &path, std::uint64_t hash) const
+{
+    CacheHeader header = {};
+    std::string temporary = path + std::format(".{}.tmp", getpid());
+    std::error_code error;
+
+    std::copy_n("RTMESH\0\0", sizeof(header.magic), header.magic);
+    header.version = cacheVersion;
+    header.depth = static_cast<std::uint32_t>(_depth);
+    header.hash = hash;
+    header.vertices = _x.size();
+    header.normals = _nx.size();
+    header.uvs = _tu.size();
+    header.triangles = _indices.size();
+    header.normalIndices = _normalIndices.size();
+    header.uvIndices = _uvIndices.size();
+    header.nodes = _nodes.size();
+
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path(), error);
+
+    std::ofstream file(temporary, std::ios::binary);
+    auto write = [&file](const auto &buffer) {
+        file.write(reinterpret_cast<const char *>(buffer.data()),
+            static_cast<std::streamsize>(buffer.size() * sizeof(buffer[0])));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const std::span<const float> *buffer :
+        {&_x, &_y, &_z, &_nx, &_ny, &_nz, &_tu, &_tv}) {
+        write(*buffer);
+    }
+    write(_indices);
+    write(_normalIndices);
+    write(_uvIndices);
+    write(_nodes);
+    file.close();
+
+    if (!file) {
+        std::cerr << "ERROR: Could not write mesh cache '" << path << "'"
+                  << std::endl;
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::cerr << "ERROR: Could not write mesh cache '" << path << "'"
+                  << std::endl;
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+/**
+ * @brief Get the surface area of a box.
+ *
+ * @param min The lower corner of the box.
+ * @param max The upper corner of the box.
+ *
+ * @return The surface area of the box.
+ */
+double Raytracer::Utils::MeshData::area(
+    const float min[3], const float max[3])
+{
+    double dx = max[0] - min[0];
+    double dy = max[1] - min[1];
+    double dz = max[2] - min[2];
+
+    return 2 * (dx * dy + dy * dz + dz * dx);
+}
+
+/**
+ * @brief Check if the ray hits the bounds of a node.
+ *
+ * This function performs the slab test against the bounds of the given node
+ * using the precomputed inverse of the ray direction.
+ *
+ * @param node The node to test.
+ * @param origin The origin of the ray.
+ * @param inverse The inverse of the ray direction.
+ * @param interval The interval to check for hits.
+ *
+ * @return true if the ray hits the node, false otherwise.
+ */
+bool Raytracer::Utils::MeshData::slab(const Node &node, const Point3 &origin,
+    const Vec3 &inverse, const Interval &interval)
+{
+    double tmin = interval.min();
+    double tmax = interval.max();
+
+    for (int axis = 0; axis < 3; axis++) {
+        double t0 = (node.min[axis] - origin[axis]) * inverse[axis];
+        double t1 = (node.max[axis] - origin[axis]) * inverse[axis];
+
+        if (inverse[axis] < 0) {
+            std::swap(t0, t1);
+        }
+
+        tmin = t0 > tmin ? t0 : tmin;
+        tmax = t1 < tmax ? t1 : tmax;
+
+        if (tmax < tmin) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find the closest triangle hit by a ray.
+ *
+ * This function traverses the BVH of the mesh like `LinearBVH` does and
+ * intersects the triangles of the leaves it reaches with the Moller-Trumbore
+ * algorithm, shrinking the interval after every hit.
+ *
+ * @param ray The ray to check for hits.
+ * @param interval The interval to check for hits.
+ * @param hit The closest hit, with the barycentric coordinates of the point
+ * relative to the second and third corners of the triangle.
+ *
+ * @return true if the ray hits the mesh, false otherwise.
+ */
+bool Raytracer::Utils::MeshData::intersect(
+    const Core::Ray &ray, Interval interval, Hit &hit) const
+{
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    const Point3 &origin = ray.origin();
+    const Vec3 &direction = ray.direction();
+    Vec3 inverse(1.0 / direction[0], 1.0 / direction[1], 1.0 / direction[2]);
+
+    std::array<std::int32_t, stackSize> fixed;
+    std::vector<std::int32_t> dynamic;
+    std::int32_t *stack = fixed.data();
+
+    if (_depth > stackSize) {
+        dynamic.resize(_depth);
+        stack = dynamic.data();
+    }
+
+    std::size_t size = 0;
+    std::int32_t current = 0;
+    bool hitAnything = false;
+
+    while (true) {
+        const Node &node = _nodes[current];
+
+        Utils::Counters::nodes++;
+
+        if (slab(node, origin, inverse, interval)) {
+            if (node.count > 0) {
+                std::uint32_t first = node.offset;
+
+                for (std::uint32_t i = first; i < first + node.count; i++) {
+                    Point3 p0 = vertex(i, 0);
+                    Vec3 e1 = vertex(i, 1) - p0;
+                    Vec3 e2 = vertex(i, 2) - p0;
+                    Vec3 p = cross(direction, e2);
+                    double determinant = dot(e1, p);
+
+                    if (std::fabs(determinant) < 1e-12) {
+                        continue;
+                    }
+
+                    double inverseDeterminant = 1.0 / determinant;
+                    Vec3 s = origin - p0;
+                    double b1 = dot(s, p) * inverseDeterminant;
+
+                    if (b1 < 0 || b1 > 1) {
+                        continue;
+                    }
+
+                    Vec3 q = cross(s, e1);
+                    double b2 = dot(direction, q) * inverseDeterminant;
+
+                    if (b2 < 0 || b1 + b2 > 1) {
+                        continue;
+                    }
+
+                    double t = dot(e2, q) * inverseDeterminant;
+
+                    if (!interval.surrounds(t)) {
+                        continue;
+                    }
+
+                    hit = {i, t, b1, b2};
+                    hitAnything = true;
+                    interval = Interval(interval.min(), t);
+                }
+            } else if (inverse[node.axis] < 0) {
+                stack[size++] = current + 1;
+                current = node.offset;
+                continue;
+            } else {
+                stack[size++] = node.offset;
+                current = current + 1;
+                continue;
+            }
+        }
+
+        if (size == 0) {
+            break;
+        }
+        current = stack[--size];
+    }
+
+    return hitAnything;
+}
+
+/**
+ * @brief Get the number of triangles of the mesh.
+ *
+ * @return The number of triangles.
+ */
+std::size_t Raytracer::Utils::MeshData::triangleCount() const
+{
+    return _indices.size() / 3;
+}
+
+/**
+ * @brief Get a corner of a triangle.
+ *
+ * @param triangle The index of the triangle.
+ * @param corner The index of the corner, from 0 to 2.
+ *
+ * @return The position of the corner.
+ */
+Raytracer::Utils::Point3 Raytracer::Utils::MeshData::vertex(
+    std::uint32_t triangle, int corner) const
+{
+    std::uint32_t i = _indices[3 * triangle + corner];
+
+    return Point3(_x[i], _y[i], _z[i]);
+}
+
+/**
+ * @brief Get the shading normal at a hit.
+ *
+ * This function interpolates the normals of the corners of the triangle that
+ * was hit.
+ *
+ * @param hit The hit.
+ *
+ * @return The unit shading normal, or nothing if the corners of the triangle
+ * have no normal.
+ */
+std::optional<Raytracer::Utils::Vec3> Raytracer::Utils::MeshData::normal(
+    const Hit &hit) const
+{
+    if (_normalIndices.empty()) {
+        return std::nullopt;
+    }
+
+    const std::uint32_t *corners = &_normalIndices[3 * hit.triangle];
+
+    if (corners[0] == none || corners[1] == none || corners[2] == none) {
+        return std::nullopt;
+    }
+
+    double weights[3] = {1 - hit.b1 - hit.b2, hit.b1, hit.b2};
+    Vec3 normal(0, 0, 0);
+
+    for (int c = 0; c < 3; c++) {
+        normal += weights[c]
+            * Vec3(_nx[corners[c]], _ny[corners[c]], _nz[corners[c]]);
+    }
+
+    if (normal.lengthSquared() == 0) {
+        return std::nullopt;
+    }
+
+    return unitVector(normal);
+}
+
+/**
+ * @brief Get the texture coordinates at a hit.
+ *
+ * This function interpolates the texture coordinates of the corners of the
+ * triangle that was hit.
+ *
+ * @param hit The hit.
+ *
+ * @return The texture coordinates, or nothing if the corners of the triangle
+ * have none.
+ */
+std::optional<std::pair<double, double>> Raytracer::Utils::MeshData::uv(
+    const Hit &hit) const
+{
+    if (_uvIndices.empty()) {
+        return std::nullopt;
+    }
+
+    const std::uint32_t *corners = &_uvIndices[3 * hit.triangle];
+
+    if (corners[0] == none || corners[1] == none || corners[2] == none) {
+        return std::nullopt;
+    }
+
+    double weights[3] = {1 - hit.b1 - hit.b2, hit.b1, hit.b2};
+    double u = 0;
+    double v = 0;
+
+    for (int c = 0; c < 3; c++) {
+        u += weights[c] * _tu[corners[c]];
+        v += weights[c] * _tv[corners[c]];
+    }
+
+    return std::make_pair(u, v);
+}
+
+/**
+ * @brief Get the bounding box of the mesh.
+ *
+ * @return The bounding box of the mesh.
+ */
+Raytracer::Utils::AxisAlignedBBox
+Raytracer::Utils::MeshData::boundingBox() const
+{
+    return _bbox;
+}
@@ -0,0 +1,118 @@
+#include "utils/Random.hpp"
+
+/**
+ * @brief Construct a new Random object.
+ *
+ * This function constructs a new Random object seeded with the given seed
+ * and stream.
+ *
+ * @param seed The seed of the generator.
+ * @param stream The stream of the generator.
+ *
+ * @return A new Random object.
+ */
+Raytracer::Utils::Random::Random(std::uint64_t seed, std::uint64_t stream)
+{
+    this->seed(seed, stream);
+}
+
+/**
+ * @brief Seed the generator.
+ *
+ * This function seeds the generator with the given seed and stream. The
+ * generator is a PCG32 generator: a 64-bit linear congruential generator
+ * whose output is permuted down to 32 bits. Generators seeded with the same
+ * seed but different streams produce independent sequences.
+ *
+ * @param seed The seed of the generator.
+ * @param stream The stream of the generator.
+ * @return void
+ */
+void Raytracer::Utils::Random::seed(std::uint64_t seed, std::uint64_t stream)
+{
+    _state = 0;
+    _increment = (stream << 1) | 1;
+    next();
+    _state += seed;
+    next();
+}
+
+/**
+ * @brief Seed the generator for a given pixel sample.
+ *
+ * This function seeds the generator from the global seed, the index of the
+ * pixel and the index of the sample. Every sample of every pixel gets its own
+ * sequence, so a sample always draws the same random numbers no matter which
+ * thread renders it or in which order the samples are taken.
+ *
+ * @param seed The global seed.
+ * @param pixel The index of the pixel.
+ * @param sample The index of the sample within the pixel.
+ * @return void
+ */
+void Raytracer::Utils::Random::seed(
+    std::uint64_t seed, std::uint64_t pixel, std::uint64_t sample)
+{
+    this->seed(mix(seed ^ mix(pixel ^ mix(sample))), pixel);
+}
+
+/**
+ * @brief Generate the next 32-bit random number.
+ *
+ * @return A uniformly distributed 32-bit random number.
+ */
+std::uint32_t Raytracer::Utils::Random::next()
+{
+    std::uint64_t old = _state;
+
+    _state = old * 6364136223846793005ULL + _increment;
+
+    std::uint32_t xorShifted =
+        static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+    std::uint32_t rot = static_cast<std::uint32_t>(old >> 59u);
+
+    return (xorShifted >> rot) | (xorShifted << ((-rot) & 31));
+}
+
+/**
+ * @brief Generate the next random double.
+ *
+ * @return A random double in [0, 1).
+ */
+double Raytracer::Utils::Random::nextDouble()
+{
+    return next() * 0x1.0p-32;
+}
+
+/**
+ * @brief Get the generator of the calling thread.
+ *
+ * Every thread has its own generator, so drawing random numbers never
+ * contends on a shared state.
+ *
+ * @return The generator of the calling thread.
+ */
+Raytracer::Utils::Random &Raytracer::Utils::Random::local()
+{
+    thread_local Random generator;
+
+    return generator;
+}
+
+/**
+ * @brief Scramble a 64-bit value.
+ *
+ * This function is the SplitMix64 finalizer. It is used to turn structured
+ * values such as pixel and sample indices into well distributed seeds.
+ *
+ * @param value The value to scramble.
+ * @return The scrambled value.
+ */
+std::uint64_t Raytracer::Utils::Random::mix(std::uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+
+    return value ^ (value >> 31);
+}
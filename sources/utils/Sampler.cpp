@@ -0,0 +1,78 @@
+#include "utils/Sampler.hpp"
+#include "interfaces/ISampler.hpp"
+
+/**
+ * @brief Start a new pixel sample.
+ *
+ * This function makes the given sampler the source of the random numbers
+ * drawn by the calling thread for the sample `index` of the pixel (x, y).
+ * No dimension is assigned until `dimensions` is called, so the numbers
+ * drawn before fall back to the random generator of the thread.
+ *
+ * @param sampler The sampler to draw from, or nullptr for the generator.
+ * @param seed The global seed.
+ * @param x The x coordinate of the pixel.
+ * @param y The y coordinate of the pixel.
+ * @param index The index of the sample within the pixel.
+ * @return void
+ */
+void Raytracer::Utils::Sampler::start(const Interfaces::ISampler *sampler,
+    std::uint64_t seed, int x, int y, std::uint32_t index)
+{
+    _sampler = sampler;
+    _seed = seed;
+    _x = x;
+    _y = y;
+    _index = index;
+    _dimension = 0;
+    _end = 0;
+}
+
+/**
+ * @brief Assign a range of dimensions to the next random numbers.
+ *
+ * This function makes the next `count` random numbers use the dimensions
+ * starting at `first` of the current sample. Random numbers drawn past the
+ * range come from the random generator of the thread, so a consumer that
+ * draws more numbers than it was given never reuses the dimensions of
+ * another one.
+ *
+ * @param first The first dimension of the range.
+ * @param count The number of dimensions in the range.
+ * @return void
+ */
+void Raytracer::Utils::Sampler::dimensions(
+    std::uint32_t first, std::uint32_t count)
+{
+    _dimension = first;
+    _end = first + count;
+}
+
+/**
+ * @brief Draw the next random number.
+ *
+ * @return A random double in [0, 1).
+ */
+double Raytracer::Utils::Sampler::next()
+{
+    if (_sampler == nullptr || _dimension >= _end) {
+        return Random::local().nextDouble();
+    }
+
+    return _sampler->value(_seed, _x, _y, _index, _dimension++);
+}
+
+/**
+ * @brief Get the sampler of the calling thread.
+ *
+ * Every thread has its own sampler state, so the pixel sample being rendered
+ * and its current dimension are never shared between threads.
+ *
+ * @return The sampler of the calling thread.
+ */
+Raytracer::Utils::Sampler &Raytracer::Utils::Sampler::local()
+{
+    thread_local Sampler sampler;
+
+    return sampler;
+}